@@ -21,24 +21,68 @@ The following code was formatted with readability in mind. Functions belonging
 to a specific class are grouped, with fuctions listed in relative order to how 
 functions are called chronologically once the program is executed.
 
+The grid size and fleet are a template parameter (a variant) of every class
+that depends on them. The standard 10x10 game with five ships is the variant
+Classic; Classic15 and Classic20 play the same fleet on larger grids, and
+RuntimeVariant plays any grid and fleet given on the command line.
+
 !!!For display purposes it may be required that the terminal be enlarged!!!
 
 TODO: There seems to be a lot of code that is repeated. It is my hope to 
       eventually slim this program down. 
-      (ie: the CheckDirection functions, EvalDirection functions, and the loops 
-      within RandomPlace are extremely similar)
+      (ie: the CheckDirection and EvalDirection functions are extremely similar)
 
 @author Dustin Ficenec, CISP 400
 @version 1.1 - 10/30/18
 */
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector> 
 #include <cctype>
 #include <cstdlib>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
 #include <limits>
+#include <cmath>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <csignal>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "battleship.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef BATTLESHIP_PROFILE
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
 using namespace std;
 
 
@@ -49,1984 +93,7659 @@ enum ShipState{AFLOAT, SUNK};
 enum Player{USER, COMP};
 
 //class prototypes
+class RandomGenerator;
 struct Square;
-class Ship;
-class AIOpponent;
-class Game;
+struct ClassicFleet;
+template<int W, int H, class Fleet> struct FixedVariant;
+class RuntimeVariant;
+template<class V> struct BasicBitboard;
+template<class V> class BasicBoard;
+template<class V> class BasicShip;
+template<class V> class BasicFleet;
+template<class V> class BasicTargetingStrategy;
+template<class V> class BasicAIOpponent;
+template<class V> class BasicMonteCarloAI;
+template<class V> class BasicGame;
+template<class V> class BasicGamePool;
+
+//prototypes of functions used by the classes below
+uint64_t NewSeed();
 
 
 // Carries data of SquareState with the ability to print a symbol correlated 
 // to that SquareState.
-// Used in constructing a grid of Squares
+// Used when displaying the squares of a Board
+// The symbols are built once; a SINK square is an X with a strike through it.
 struct Square{
   private:
     SquareState state;
+    static constexpr string_view symbols[6] = {" O ", " X ", "   ", "!S!", 
+                                               "\u0336 \u0336X\u0336 ", " + "};
   public:
-    Square(){
-      state = EMPTY;
-    }
-    void Print();
+    explicit Square(SquareState s = EMPTY){
+      state = s;
+    } 
+    void Print(ostream &os);
+    // Returns the three characters the square is drawn with
+    string_view getSymbol() const {return symbols[state];}
     //In-line getter & setter for state
     SquareState getSquareState() const {return state;}
-    const void setSquareState(SquareState s) {state = s;}
+    void setSquareState(SquareState s) {state = s;}
 };
 
 
-// Specification C1 - OOP
-// Ship manages all neccesary data correlated to each ship of BATTLESHIP
-class Ship{
-  private:
-    string shipName;                      // name of the ship
-    vector<pair<int, int> > shipCoords;   // set of coordinates where ship object is located on grid
-    ShipState shipState;                  // state of the ship (either SUNK or AFLOAT)
-    int shipSize,                         // number of spaces a ship occupies
-        health;                           // amount of damage a ship can take before it is SUNK
-  public:
-    // Constructor Initializes all data variables based on the given arguments
-    Ship(int s, string name){
-      shipSize = s;
-      health = s;
-      shipName = name;
-      shipState = AFLOAT;
-    }
-    void Damage();
-    // Getters and setter for the various ship data
-    void setShipState(ShipState s) {shipState = s;}
-    ShipState getShipState() const {return shipState;}
-    int getSize() const {return shipSize;}
-    int getHealth(){return health;}
-    string getName(){return shipName;}
-    void setCoords(vector<pair<int, int> > coords){shipCoords = coords;}
-    vector<pair<int,int> > const &getCoords() const {return shipCoords;}
+// The standard fleet of five ships, largest first
+struct ClassicFleet{
+  static constexpr int numShips = 5;
+  static constexpr int sizes[numShips] = {5, 4, 3, 3, 2};
+  static constexpr const char *names[numShips] = {"CARRIER", "BATTLESHIP", "CRUISER",
+                                                  "SUBMARINE", "DESTROYER"};
 };
 
 
-// Essential set of functions for running the targeting algorithm that competes 
-// against the human player
-class AIOpponent{
-  public:
-    // Empty default constructor
-    AIOpponent() = default;
-    pair<int, int> EvaluateGrid(const Game& game, int s);
-    bool EvalUp(const Game &game, int x, int y, int s);
-    bool EvalDown(const Game &game, int x, int y, int s);
-    bool EvalRight(const Game &game, int x, int y, int s);
-    bool EvalLeft(const Game &game, int x, int y, int s);
-    int SmallestShipAlive(const Game &game);
-    void DisplayProbabilityGrid(int grid [10][10]);
-    friend class Game;
-};
+// Returns the largest of the n ship sizes
+constexpr int LargestShip(const int sizes[], int n){
+  int largest = 0;
+  for(int i = 0; i < n; i++){
+    largest = sizes[i] > largest ? sizes[i] : largest;
+  }
+  return largest;
+}
 
 
-// Extensive class which manages a vast majority of game functionality
-// * Handles all persistent grids and ships belonging to the player and computer
-// * Handles writing/recording actions to a log file with the current date 
-//   and/or time
-// * Manages the Gametype selected and all subsequent function changes resulting 
-//   from the given Gametype
-// * Displays all necessary output for the game to run
-// * Takes input from the user in order to place ships and target squares on the 
-//   grid(s)
-class Game{
-  private:
-    Gamestate gameState;              // Helps keep track of what is currently happening in the game
-    Gametype gameType;                // Determines what aspects of the game will be enabled/disabled
-    ofstream file;                    // New file to be written to
-    Square userShips[10][10];       // Grid showing where the player's ships are
-    Square playerTargeting[10][10];   // Grid showing where the player has fired
-    Square compShips[10][10];         // Grid showing where the computer's ships are
-    Square compTargeting[10][10];     // Grid showing where the computer has fired
-    vector<Ship> userFleet;         // Container of all ships belonging to the player
-    vector<Ship> compFleet;           // Container of all ships belonging to the computer
-    AIOpponent arty;                  // Computer opponent
-  public:
-    // Initializes a new game with the given Gametype
-    explicit Game(Gametype gt){
-      gameState = WAITING;
-      gameType = gt;
-      srand (time(nullptr));           // Seeds a random number generator for later use
-      //Specification B2 - Log file to Disk
-      file.open("log.txt");
-      userFleet = vector<Ship>();
-      compFleet = vector<Ship>();
-    }
-    void Initialize();
-    bool NewGameMenu();
-    void ConstructFleets();
-    void Play();
-    void PlayerTurn();
-    void CompTurn();
-    void CheckHit(pair <int, int> target, Player p);
-    void ShipHit(int tarCol, int tarRow, Player p);
-    int GetShip(pair<int, int> coords, Player p);
-    bool IsFleetDestroyed(Player p);
-    pair<int, int> PromptFire();
-    bool CheckWin(Player p);
-    void Forfeit(Player p);
-    void RandomPlacement(Player p);
-    void RandomPlace(int shipLoc,Player p);
-    int getRandomDirection(int x, int y, int s);
-    void ManualPlacement();
-    bool CheckUp(int x, int y, int s);
-    bool CheckDown(int x, int y, int s);
-    bool CheckLeft(int x, int y, int s);
-    bool CheckRight(int x, int y, int s);
-    int DirectionMenu(int x, int y, int shipSize);
-    void PromptPlacement(int shipLoc);
-    void DisplayGrid(Square grid[10][10], Player p);
-    void PlaceShip(vector<pair<int, int> > coords, Player p);
-    bool ShootDownMissile();
-    void LogStart();
-    void LogGameType();
-    void LogShipPlace(int shipLoc, Player p);
-    void LogFire(int tarCol, int tarRow, Player p);
-    void LogHit();
-    void LogMiss();
-    void LogShotDown();
-    void LogDamage(int shipLoc, Player p);
-    void LogSink(int shipLoc, Player p);
-    void LogWin(Player p);
-    void LogExit();
-    string GetDate();
-    string GetTime();
-    void PrintShipP1(int shipLoc);
-    void PrintShipP2(int shipLoc);
-    void SinkShip(int shipLoc, Player p);
-    int NumShipsAlive(Player p);
-    friend class AIOpponent;
+// A grid size and fleet fixed at compile time.
+// Every grid is W columns (numbered from 1) by H rows (lettered from A), and
+// Fleet lists the size and name of each ship like ClassicFleet. Since every
+// grid size and loop bound is a constant, masks and tables are sized exactly
+// and the compiler can unroll the loops over them.
+// The members below make up the interface every variant provides.
+template<int W, int H, class Fleet>
+struct FixedVariant{
+  static constexpr bool fixed = true;                   // tables are built at compile time
+  static constexpr int maxWidth = W,                    // most columns a grid can have
+                       maxHeight = H,                   // most rows a grid can have
+                       maxSquares = W * H,              // most squares a grid can have
+                       maxShips = Fleet::numShips,      // most ships a fleet can have
+                       maxShipSize = LargestShip(Fleet::sizes, Fleet::numShips);
+  static_assert(H <= 26, "rows are lettered A-Z");
+  static_assert(maxShipSize <= W && maxShipSize <= H, "every ship must fit on the grid");
+  static_assert(Fleet::numShips < 32, "afloat ships are kept in an int mask");
+  static constexpr int Width() {return W;}
+  static constexpr int Height() {return H;}
+  static constexpr int Squares() {return W * H;}
+  static constexpr int NumShips() {return Fleet::numShips;}
+  static constexpr int ShipSize(int i) {return Fleet::sizes[i];}
+  static const char *ShipName(int i) {return Fleet::names[i];}
 };
 
 
-//function prototypes
-void ProgramGreeting();
-Gametype MainMenu();
-string StrikeName(const string& str);
+// The standard game, and the standard fleet on larger grids
+using Classic = FixedVariant<10, 10, ClassicFleet>;
+using Classic15 = FixedVariant<15, 15, ClassicFleet>;
+using Classic20 = FixedVariant<20, 20, ClassicFleet>;
 
 
+// A grid size and fleet chosen when the program starts, for the grids and
+// fleets no FixedVariant covers. Masks and tables are sized for the largest
+// grid and fleet allowed and the loop bounds are read at run time, so games
+// are slower than with a FixedVariant of the same size.
+// Configure must succeed before the first game is created.
+class RuntimeVariant{
+  private:
+    static inline int width = 0,              // columns of the grid
+                      height = 0,             // rows of the grid
+                      numShips = 0;           // ships in each fleet
+    static inline int sizes[10];              // size of each ship
+    static inline string names[10];           // name of each ship
+  public:
+    static constexpr bool fixed = false;      // tables are built by Configure
+    static constexpr int maxWidth = 26,
+                         maxHeight = 26,
+                         maxSquares = 26 * 26,
+                         maxShips = 10,
+                         maxShipSize = 8;
+    static int Width() {return width;}
+    static int Height() {return height;}
+    static int Squares() {return width * height;}
+    static int NumShips() {return numShips;}
+    static int ShipSize(int i) {return sizes[i];}
+    static const char *ShipName(int i) {return names[i].c_str();}
+    static bool Configure(int w, int h, const vector<int> &fleet);
+};
 
-int main() {
-  ProgramGreeting();
-  bool playing = true;    // bool to enable continued play
 
-  while(playing){
-    Game game = Game(MainMenu());
-    game.Initialize();
-    game.Play();
-    if(!game.NewGameMenu()){
-      playing = false;
+// Set of squares on the grid of variant V packed into 64-bit words.
+// The square at grid point (x,y) is stored in bit x * height + y; bits past
+// the last square are always clear so that masks can be compared and counted
+// directly. The 10x10 grid of Classic fits in two words.
+template<class V>
+struct BasicBitboard{
+  static constexpr int numWords = (V::maxSquares + 63) / 64;
+  uint64_t words[numWords];
+  constexpr BasicBitboard() : words{} {}
+
+  static constexpr int Index(int x, int y) {return x * V::Height() + y;}
+  // Mask containing only bit i
+  static constexpr BasicBitboard Bit(int i){
+    BasicBitboard b;
+    for(int w = 0; w < numWords; w++){
+      b.words[w] = (i >> 6) == w ? 1ULL << (i & 63) : 0;
+    } 
+    return b;
+  }
+  static constexpr BasicBitboard At(int x, int y) {return Bit(Index(x, y));}
+  // Mask containing bits 0 through n - 1
+  static constexpr BasicBitboard LowBits(int n){
+    BasicBitboard b;
+    for(int w = 0; w < numWords; w++){
+      int bits = n - 64 * w;    // bits of word w in the mask
+      b.words[w] = bits >= 64 ? ~0ULL : bits > 0 ? (1ULL << bits) - 1 : 0;
+    } 
+    return b;
+  }
+  // Mask containing every square of the grid, folded to a constant for
+  // the variants compiled for one grid size
+  static constexpr BasicBitboard Full(){
+    if constexpr(V::fixed){
+      constexpr BasicBitboard full = LowBits(V::Squares());
+      return full;
+    }
+    else{
+      return LowBits(V::Squares());
     }
   }
+  // Squares (x,y) through (x,y + len - 1)
+  static constexpr BasicBitboard Vertical(int x, int y, int len){
+    BasicBitboard b;
+    for(int j = 0; j < len; j++){
+      b |= At(x, y + j);
+    } 
+    return b;
+  }
+  // Squares (x,y) through (x + len - 1,y)
+  static constexpr BasicBitboard Horizontal(int x, int y, int len){
+    BasicBitboard b;
+    for(int j = 0; j < len; j++){
+      b |= At(x + j, y);
+    } 
+    return b;
+  }
 
-  return 0;
-}
-
+  // The word loops below only index words with the loop counter so that the
+  // compiler unrolls them and keeps a Classic mask in two registers.
+  constexpr bool Test(int i) const {
+    for(int w = 0; w < numWords - 1; w++){
+      if(i < 64 * (w + 1)){
+        return (words[w] >> (i - 64 * w)) & 1;
+      }
+    } 
+    return (words[numWords - 1] >> (i - 64 * (numWords - 1))) & 1;
+  }
+  constexpr bool Any() const {
+    uint64_t any = 0;
+    for(int w = 0; w < numWords; w++){
+      any |= words[w];
+    } 
+    return any != 0;
+  }
+  constexpr int Count() const {
+    int count = 0;
+    for(int w = 0; w < numWords; w++){
+      count += __builtin_popcountll(words[w]);
+    } 
+    return count;
+  }
+  // Index of the lowest set bit; the mask must not be empty
+  constexpr int LowestBit() const {
+    for(int w = 0; w < numWords - 1; w++){
+      if(words[w] != 0){
+        return 64 * w + __builtin_ctzll(words[w]);
+      }
+    } 
+    return 64 * (numWords - 1) + __builtin_ctzll(words[numWords - 1]);
+  }
+  // Clears the lowest set bit, used to walk the squares of a mask
+  constexpr void ClearLowestBit() {
+    for(int w = 0; w < numWords - 1; w++){
+      if(words[w] != 0){
+        words[w] &= words[w] - 1;
+        return;
+      }
+    } 
+    words[numWords - 1] &= words[numWords - 1] - 1;
+  }
 
-//ProgramGreeting - USE ENLARGED TERMINAL WINDOW
-void ProgramGreeting(){
-  cout << " __________    _________________________________    ___________ _________ ___ ___ ______________" << endl
-       << " \\______   \\  /  _  \\__    ___/\\__    ___/|    |    \\_   _____//   _____//   |   \\|   \\______   \\ " << endl
-       << "  |    |  _/ /  /_\\  \\|    |     |    |   |    |     |    __)_ \\_____  \\/    ~    \\   ||     ___/ " << endl
-       << "  |    |   \\/    |    \\    |     |    |   |    |___  |        \\/        \\    Y    /   ||    |    " <<endl
-       << "  |________/\\____|____/____|     |____|   |________\\/_________/_________/\\___|___/|___||____|" << endl
-       << "\nWelcome to BATTLESHIP, a classic game of wit and strategy."
-       << " In this game, you will be pitted against the best battleship player"
-       << " known to humankind: a computer. Good luck and godspeed." << endl
-       << "\nPress Enter to Continue";
-  // Waits for the user to press enter. Ignores all other input.
-  cin.ignore(numeric_limits<streamsize>::max(),'\n'); 
-}
+  constexpr BasicBitboard operator&(BasicBitboard b) const {return b &= *this;}
+  constexpr BasicBitboard operator|(BasicBitboard b) const {return b |= *this;}
+  constexpr BasicBitboard operator^(BasicBitboard b) const {
+    for(int w = 0; w < numWords; w++){
+      b.words[w] ^= words[w];
+    } 
+    return b;
+  }
+  // Complement within the squares of the grid
+  constexpr BasicBitboard operator~() const {
+    BasicBitboard b = Full();
+    for(int w = 0; w < numWords; w++){
+      b.words[w] &= ~words[w];
+    } 
+    return b;
+  }
+  constexpr BasicBitboard &operator&=(BasicBitboard b) {
+    for(int w = 0; w < numWords; w++){
+      words[w] &= b.words[w];
+    } 
+    return *this;
+  }
+  constexpr BasicBitboard &operator|=(BasicBitboard b) {
+    for(int w = 0; w < numWords; w++){
+      words[w] |= b.words[w];
+    } 
+    return *this;
+  }
+  constexpr bool operator==(BasicBitboard b) const {
+    uint64_t diff = 0;
+    for(int w = 0; w < numWords; w++){
+      diff |= words[w] ^ b.words[w];
+    } 
+    return diff == 0;
+  }
+  constexpr bool operator!=(BasicBitboard b) const {return !(*this == b);}
+};
 
 
-// Prompts the user the select a Gametype through use of a numeric menu
-// returns the Gametype selected
-Gametype MainMenu(){
-  Gametype gT = CLASSIC;    // initialized gametype to be returned
-  int input;                // input from user
-  bool valid = false;       // bool to ensure valid entry
-  while(!valid){
-    cout << "\n___________________"
-         << "\n| SELECT GAME TYPE \\" 
-         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
-         << "\n1. Classic"
-         << "\n2. Multifire"
-         << "\n3. Cruise Missiles"
-         << "\n4. Hardcore"
-         << "\n5. Game Type Descriptions"
-         << "\n6. Exit" 
-         << endl;
-    cin >> input;
-    cin.clear();
-    cin.ignore( 256, '\n' );
-    switch(input) {
-      case 1: gT = CLASSIC;
-        valid = true;
-        break;
-      // Specification A2 - MultiFire Game
-      case 2: gT = MULTIFIRE;
-        valid = true;
-        break;
-      // Specification A3 - Cruise Missiles
-      case 3: gT = CRUISE_MISSILES;
-        valid = true;
-        break;
-      case 4: gT = HARDCORE;
-        valid = true;
-        break;
-      case 5:
-      {
-        cout << "\nCLASSIC - The name says it all. Place your ships in the water"
-             << "and attempt to locate where the enemy placed their ships."
-             << "Each player gets to fire once per turn. First one to sink all"
-             << "of the opponent's ships wins." << endl
-             << "\nMULTIFIRE - Classic, but with a twist. Each player gets to "
-             << "fire once for each ship afloat in their fleet." << endl
-             << "\nCRUISE MISSILES - Yet another take on the original, this game"
-             << "type takes a more modern perspective. In this mode ships have "
-             << "an 80% chance to shoot down incoming missiles." << endl
-             << "\nHARDCORE - Absolute mayhem. Combines all of the features of"
-             << "the previous game types into one explosive package." << endl;
-        break;
+// A grid of variant V stored as one Bitboard per SquareState.
+// Every square is a member of exactly one of the masks, so the state of a 
+// square is found by testing the masks and a whole set of squares can be 
+// changed with a handful of mask operations. 
+// The 10x10 grid is 96 bytes and can be copied or compared with memcpy/memcmp.
+template<class V>
+class BasicBoard{
+  private:
+    using Bitboard = BasicBitboard<V>;
+    Bitboard masks[6];    // one mask per SquareState, indexed by the SquareState
+  public:
+    // Constructs a grid where every square is EMPTY
+    BasicBoard(){
+      masks[EMPTY] = Bitboard::Full();
+    } 
+    // Makes every square EMPTY again
+    void Clear(){
+      for(Bitboard &m : masks){
+        m = Bitboard();
       }
-      case 6:
-      {
-        cout << "Goodbye!" << endl;
-        exit(0);
+      masks[EMPTY] = Bitboard::Full();
+    } 
+    SquareState getSquareState(int x, int y) const {
+      int i = Bitboard::Index(x, y);
+      for(int s = MISS; s < SHOT_DOWN; s++){
+        if(masks[s].Test(i)){
+          return SquareState(s);
+        }
       }
-      // Bulletproof - prevents all entries other than numbers 1-6
-      default: cout << "\nInvalid entry, please enter a number from 1 through 6"
-                    << "(no decimals)." << endl;
-        break;
+      return SHOT_DOWN;
+    } 
+    void setSquareState(int x, int y, SquareState s) {setSquares(Bitboard::At(x, y), s);}
+    // Sets the state of every square contained in b to s
+    void setSquares(Bitboard b, SquareState s){
+      Bitboard keep = ~b;
+      for(Bitboard &m : masks){
+        m &= keep;
+      }
+      masks[s] |= b;
+    } 
+    // Returns the set of squares with the SquareState s
+    Bitboard getMask(SquareState s) const {return masks[s];}
+    // Replaces the set of squares with the SquareState s; the masks of a grid
+    // must not overlap and together cover every square
+    void setMask(SquareState s, Bitboard b) {masks[s] = b;}
+    bool operator==(const BasicBoard &b) const {
+      for(int s = MISS; s <= SHOT_DOWN; s++){
+        if(masks[s] != b.masks[s]){
+          return false;
+        }
+      }
+      return true;
+    } 
+};
+
+
+// A block of targeting grids laid out as a structure of arrays for 
+// AIOpponent::EvaluateBatch: masks[s][b] is the set of squares of grid b with
+// the SquareState s, and smallest[b] is the size of the smallest ship AFLOAT 
+// on it. Each array is contiguous and read front to back by EvaluateBatch.
+template<class V>
+struct BasicBoardBatch{
+  using Bitboard = BasicBitboard<V>;
+  vector<Bitboard> masks[6];    // one array per SquareState, indexed by the SquareState
+  vector<int> smallest;         // smallest ship AFLOAT on each grid
+  int Size() const {return smallest.size();}
+  void Clear(){
+    for(vector<Bitboard> &m : masks){
+      m.clear();
     }
+    smallest.clear();
   }
-  return gT;
-}
+  // Appends a grid whose smallest ship AFLOAT has size s
+  void Add(const BasicBoard<V> &grid, int s){
+    for(int st = MISS; st <= SHOT_DOWN; st++){
+      masks[st].push_back(grid.getMask(SquareState(st)));
+    }
+    smallest.push_back(s);
+  }
+  // Returns grid b of the batch
+  BasicBoard<V> getBoard(int b) const {
+    BasicBoard<V> grid;
+    for(int st = MISS; st <= SHOT_DOWN; st++){
+      grid.setMask(SquareState(st), masks[st][b]);
+    }
+    return grid;
+  }
+};
+
+
+// Direction offsets used by the placement tables: 0 = up, 1 = down, 2 = left, 3 = right
+constexpr int dirX[4] = {0, 0, -1, 1};
+constexpr int dirY[4] = {-1, 1, 0, 0};
 
 
-// Returns the given str with a strike through it
-// i.e. StrikeName("CARRIER") returns C̶A̶R̶R̶I̶E̶R
-string StrikeName(const string& str) {
-  string struck;
-  for (auto ch : str) {
-    struck.append(u8"\u0336");
-    struck.push_back(ch);
+// Number of placements of ships of size 2 to maxSize on a w by h grid in both
+// orientations
+constexpr int NumPlacements(int w, int h, int maxSize){
+  int n = 0;
+  for(int k = 2; k <= maxSize; k++){
+    n += w * (h - k + 1) + (w - k + 1) * h;
   }
-  return struck;
+  return n;
 }
 
 
-// Prints the SquareState of a Square.
-// Each state is represented by a symbol.
-void Square::Print(){
-  switch(state){
-    case HIT:   cout << " X ";
-      break;
-    case MISS:  cout << " O ";
-      break;
-    case EMPTY: cout << "   ";
-      break;
-    case SHIP:  cout << "!S!";
-      break;
-    case SINK:  cout << StrikeName(" X ");
-      break;
-    case SHOT_DOWN: cout << " + ";
-      break;
+// Sum of the squares of the placements counted by NumPlacements, where a
+// placement of size k covers k - unused squares
+constexpr int NumCovers(int w, int h, int maxSize, int unused){
+  int n = 0;
+  for(int k = 2; k <= maxSize; k++){
+    n += (w * (h - k + 1) + (w - k + 1) * h) * (k - unused);
   }
+  return n;
 }
 
 
-/*
-  Below exists all functions for class Game.
-  The amount of code is extensive, however it has been divided up logically
-  in order to enhance readability.
+// Every placement of a ship of size 2 to V::maxShipSize on the grid of
+// variant V. The placements of size k are masks[first[k]] through
+// masks[first[k + 1] - 1]. at[] finds a placement from its lowest square (the
+// top or leftmost square) and cover[] lists every placement that covers a
+// given square.
+// The table of a RuntimeVariant is sized for its largest grid.
+template<class V>
+struct ShipPlacementTable{
+  using Bitboard = BasicBitboard<V>;
+  static constexpr int numPlacements = NumPlacements(V::maxWidth, V::maxHeight, V::maxShipSize);
+  static constexpr int numCovers = NumCovers(V::maxWidth, V::maxHeight, V::maxShipSize, 0);
+  static_assert(numPlacements < 32768, "placements are stored as shorts");
+  Bitboard masks[numPlacements];              // squares covered by each placement
+  int first[V::maxShipSize + 2];              // index of the first placement of each size
+  short at[2][V::maxShipSize + 1][V::maxSquares];   // at[vertical][k][i] = placement of size k whose
+                                              // lowest square is i; -1 if it runs off the grid
+  int coverFirst[V::maxSquares + 1];          // the placements covering square i are
+  short cover[numCovers];                     // cover[coverFirst[i]] to cover[coverFirst[i + 1] - 1]
+  constexpr void Build();
+};
 
-  SECTION 1: PLACEMENT
-  SECTION 2: PLAY
-  SECTION 3: LOG
-*/
 
-/*
-  SECTION 1: PLACEMENT
+// Every placement counted by AIOpponent's density map on the grid of variant V.
+// A counted placement of size k starts at a square, heads in one of the four 
+// directions and counts its starting square plus the next k - 2 squares. It 
+// fits when the starting square is EMPTY, k squares fit on the grid, and none of 
+// the squares between the start and the far end (interior) is a MISS or SINK.
+// laneX and laneY give the grid point of each lane of the GridKernels.
+template<class V>
+struct DensityPlacementTable{
+  using Bitboard = BasicBitboard<V>;
+  static constexpr int numPlacements = 2 * NumPlacements(V::maxWidth, V::maxHeight, V::maxShipSize);
+  static constexpr int numCovers = 2 * NumCovers(V::maxWidth, V::maxHeight, V::maxShipSize, 1);
+  static constexpr int numLanes = (V::maxSquares + 15) / 16 * 16;
+  static_assert(numPlacements < 32768, "placements are stored as shorts");
+  Bitboard counted[numPlacements];            // squares a placement adds weight to
+  Bitboard interior[numPlacements];           // squares that may not be a MISS or SINK
+  short origin[numPlacements];                // starting square of each placement
+  unsigned char size[numPlacements];          // ship size of each placement
+  int count;                                  // placements on the current grid
+  short at[4][V::maxShipSize + 1][V::maxSquares];   // at[d][k][i] = placement of size k starting at
+                                              // square i heading in direction d; -1 if it runs off the grid
+  int coverFirst[V::maxSquares + 1];          // the placements counted at square i are
+  short cover[numCovers];                     // cover[coverFirst[i]] to cover[coverFirst[i + 1] - 1]
+  int16_t laneX[numLanes], laneY[numLanes];   // grid point of square i; 0x7FFF past the last square
+  constexpr void Build();
+};
 
-  This section deals with the initialization of the game and the placement of ships,
-  both random and manual, for both the computer and the user.
-*/
 
+// Density map of AIOpponent for an empty grid of variant V, where every
+// placement fits.
+// density[k - 2][i] = placements of size k counted at square i
+template<class V>
+struct EmptyDensityTable{
+  int density[V::maxShipSize - 1][V::maxSquares];
+  constexpr void Build(const DensityPlacementTable<V> &placements);
+};
 
-// Initializes the game by calling for the cration of all needed ships
-// Prompts the user for what type of placement they wish to use for their
-// fleet.
-void Game::Initialize(){
-  LogStart();
-  LogGameType();
-  ConstructFleets();
-  
-  bool choiceMade = false;    // ensures valid input
-  int input;                  // input from user
-  while(!choiceMade){
-    cout << "\n___________________"
-         << "\n| SELECT PLACEMENT \\"
-         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
-         << "\n1. Random Placement"
-         << "\n2. Manual Placement"
-         << "\n3. Exit" 
-         << endl;
-    cin >> input;
+
+// Fills the ShipPlacementTable for the grid of variant V
+template<class V>
+constexpr void ShipPlacementTable<V>::Build(){
+  int n = 0;    // placements added so far
+  for(int k = 2; k <= V::maxShipSize; k++){
+    first[k] = n;
+    for(int vertical = 0; vertical < 2; vertical++){
+      for(int i = 0; i < V::maxSquares; i++){
+        int x = i / V::Height(), y = i % V::Height();
+        at[vertical][k][i] = -1;
+        if(i < V::Squares() && (vertical ? y + k <= V::Height() : x + k <= V::Width())){
+          masks[n] = vertical ? Bitboard::Vertical(x, y, k) : Bitboard::Horizontal(x, y, k);
+          at[vertical][k][i] = n++;
+        }
+      }
+    } 
+  }
+  first[V::maxShipSize + 1] = n;
+  // Counts the placements covering each square, then lists them in order
+  int next[V::maxSquares + 1] = {};   // next free cover entry of each square
+  for(int p = 0; p < n; p++){
+    for(Bitboard m = masks[p]; m.Any(); m.ClearLowestBit()){
+      next[m.LowestBit() + 1]++;
+    } 
+  }
+  for(int i = 0; i < V::maxSquares; i++){
+    next[i + 1] += next[i];
+    coverFirst[i] = next[i];
+  }
+  coverFirst[V::maxSquares] = next[V::maxSquares];
+  for(int p = 0; p < n; p++){
+    for(Bitboard m = masks[p]; m.Any(); m.ClearLowestBit()){
+      cover[next[m.LowestBit()]++] = p;
+    } 
+  }
+}
+
+
+// Fills the DensityPlacementTable for the grid of variant V
+template<class V>
+constexpr void DensityPlacementTable<V>::Build(){
+  int n = 0;    // placements added so far
+  for(int i = 0; i < numLanes; i++){
+    laneX[i] = i < V::Squares() ? i / V::Height() : 0x7FFF;
+    laneY[i] = i < V::Squares() ? i % V::Height() : 0x7FFF;
+  }
+  for(int d = 0; d < 4; d++){
+    for(int k = 2; k <= V::maxShipSize; k++){
+      for(int i = 0; i < V::maxSquares; i++){
+        int x = i / V::Height(), y = i % V::Height();
+        int endX = x + (k - 1) * dirX[d], endY = y + (k - 1) * dirY[d];   // far end of the ship
+        at[d][k][i] = -1;
+        if(i >= V::Squares() || endX < 0 || endX >= V::Width() || endY < 0 || endY >= V::Height()){
+          continue;
+        }
+        counted[n] = interior[n] = Bitboard();
+        for(int j = 0; j < k - 1; j++){
+          counted[n] |= Bitboard::At(x + j * dirX[d], y + j * dirY[d]);
+          if(j > 0){
+            interior[n] |= Bitboard::At(x + j * dirX[d], y + j * dirY[d]);
+          }
+        }
+        origin[n] = i;
+        size[n] = k;
+        at[d][k][i] = n++;
+      }
+    } 
+  }
+  count = n;
+  // Counts the placements counted at each square, then lists them in order
+  int next[V::maxSquares + 1] = {};   // next free cover entry of each square
+  for(int p = 0; p < n; p++){
+    for(Bitboard m = counted[p]; m.Any(); m.ClearLowestBit()){
+      next[m.LowestBit() + 1]++;
+    } 
+  }
+  for(int i = 0; i < V::maxSquares; i++){
+    next[i + 1] += next[i];
+    coverFirst[i] = next[i];
+  }
+  coverFirst[V::maxSquares] = next[V::maxSquares];
+  for(int p = 0; p < n; p++){
+    for(Bitboard m = counted[p]; m.Any(); m.ClearLowestBit()){
+      cover[next[m.LowestBit()]++] = p;
+    } 
+  }
+}
+
+
+// Fills the EmptyDensityTable from the DensityPlacementTable
+template<class V>
+constexpr void EmptyDensityTable<V>::Build(const DensityPlacementTable<V> &placements){
+  for(int k = 0; k < V::maxShipSize - 1; k++){
+    for(int i = 0; i < V::maxSquares; i++){
+      density[k][i] = 0;
+    } 
+  }
+  for(int p = 0; p < placements.count; p++){
+    for(BasicBitboard<V> m = placements.counted[p]; m.Any(); m.ClearLowestBit()){
+      density[placements.size[p] - 2][m.LowestBit()]++;
+    } 
+  }
+}
+
+
+// Returns table T of a FixedVariant built at compile time
+template<class T>
+constexpr T BuiltTable(){
+  T table{};
+  table.Build();
+  return table;
+}
+
+
+// The placement tables of variant V.
+// A FixedVariant's tables are generated at compile time.
+template<class V, bool Fixed = V::fixed>
+struct PlacementTables{
+  static constexpr ShipPlacementTable<V> ship = BuiltTable<ShipPlacementTable<V> >();
+  static constexpr DensityPlacementTable<V> density = BuiltTable<DensityPlacementTable<V> >();
+  static constexpr EmptyDensityTable<V> emptyDensity = [](){
+    EmptyDensityTable<V> table{};
+    table.Build(density);
+    return table;
+  }();
+};
+
+
+// A RuntimeVariant's tables are built by RuntimeVariant::Configure, once the
+// grid size is known.
+template<class V>
+struct PlacementTables<V, false>{
+  static inline ShipPlacementTable<V> ship;
+  static inline DensityPlacementTable<V> density;
+  static inline EmptyDensityTable<V> emptyDensity;
+  static void Build(){
+    ship.Build();
+    density.Build();
+    emptyDensity.Build(density);
+  }
+};
+
+
+static_assert(PlacementTables<Classic>::ship.coverFirst[100] == ShipPlacementTable<Classic>::numCovers,
+              "ship placement table size");
+static_assert(PlacementTables<Classic>::density.coverFirst[100] == DensityPlacementTable<Classic>::numCovers,
+              "density table size");
+
+
+// Lists every placement of a ship of size k that covers none of the occupied 
+// squares, in ShipPlacementTable order.
+// legal must have room for ShipPlacementTable<V>::numPlacements placements.
+// Returns the number of placements listed.
+template<class V>
+inline int LegalPlacements(BasicBitboard<V> occupied, int k, short legal[]){
+  const ShipPlacementTable<V> &table = PlacementTables<V>::ship;
+  int n = 0;    // placements listed so far
+  for(int p = table.first[k]; p < table.first[k + 1]; p++){
+    legal[n] = p;
+    n += !(table.masks[p] & occupied).Any();
+  }
+  return n;
+}
+
+
+// Fast random number generator owned by a single Game (xoshiro256**).
+// The 256 bits of state are expanded from a single 64-bit seed with splitmix64,
+// so the seed alone is enough to reproduce every random choice of a game.
+// Bounded draws use Lemire's multiply-shift method, which rejects the few 
+// values that would otherwise make small results more likely than large ones.
+class RandomGenerator{
+  private:
+    uint64_t state[4];    // xoshiro256** state, never all zero
+    uint64_t seed;        // seed the state was expanded from
+    uint64_t draws;       // number of values drawn since seeding
+    static uint64_t Rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+  public:
+    explicit RandomGenerator(uint64_t s = 0) {Seed(s);}
+    // Resets the generator to the start of the sequence for seed s
+    void Seed(uint64_t s){
+      seed = s;
+      draws = 0;
+      for(uint64_t &word : state){
+        s += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = s;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31);
+      }
+    } 
+    // Returns the next 64 random bits
+    uint64_t Next(){
+      uint64_t result = Rotl(state[1] * 5, 7) * 9;
+      uint64_t t = state[1] << 17;
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = Rotl(state[3], 45);
+      draws++;
+      return result;
+    } 
+    // Returns a uniformly distributed integer from 0 to n - 1
+    int Below(uint32_t n){
+      uint64_t m = (Next() >> 32) * n;
+      uint32_t low = uint32_t(m);
+      if(low < n){
+        uint32_t threshold = -n % n;    // 2^32 mod n values to reject
+        while(low < threshold){
+          m = (Next() >> 32) * n;
+          low = uint32_t(m);
+        }
+      }
+      return int(m >> 32);
+    } 
+    uint64_t getSeed() const {return seed;}
+    uint64_t getDraws() const {return draws;}
+};
+
+
+// Specification C1 - OOP
+// Ship manages all neccesary data correlated to each ship of BATTLESHIP
+// A ship is stored entirely in place: its name refers to the variant's 
+// ship names and its coordinates are kept in a fixed size array.
+template<class V>
+class BasicShip{
+  private:
+    using Bitboard = BasicBitboard<V>;
+    string_view shipName;                 // name of the ship, owned by variant V
+    pair<int, int> shipCoords[V::maxShipSize];  // coordinates where ship object is located on grid; 
+                                                // the first shipSize are used
+    Bitboard shipMask;                    // the same coordinates as a set of grid squares
+    ShipState shipState;                  // state of the ship (either SUNK or AFLOAT)
+    int shipSize,                         // number of spaces a ship occupies
+        health;                           // amount of damage a ship can take before it is SUNK
+  public:
+    // Constructor Initializes all data variables based on the given arguments
+    BasicShip(int s = 0, string_view name = ""){
+      shipSize = s;
+      health = s;
+      shipName = name;
+      shipState = AFLOAT;
+    } 
+    void Damage();
+    // Getters and setter for the various ship data
+    void setShipState(ShipState s) {shipState = s;}
+    ShipState getShipState() const {return shipState;}
+    int getSize() const {return shipSize;}
+    int getHealth(){return health;}
+    string_view getName() const {return shipName;}
+    void setCoords(const pair<int, int> coords[]);
+    void setMask(Bitboard mask);
+    // Returns the shipSize coordinates of the ship, stored inside the ship
+    const pair<int, int> *getCoords() const {return shipCoords;}
+    Bitboard getMask() const {return shipMask;}
+};
+
+
+// The ships of one player, stored in a fixed size array so that a fleet can
+// be built and rebuilt without allocating.
+template<class V>
+class BasicFleet{
+  private:
+    using Ship = BasicShip<V>;
+    Ship ships[V::maxShips];    // the ships of the fleet; the first numShips are used
+    int numShips = 0;           // number of ships in the fleet
+  public:
+    void Clear() {numShips = 0;}
+    void Add(const Ship &ship) {ships[numShips++] = ship;}
+    int getNumShips() const {return numShips;}
+    Ship &operator[](int i) {return ships[i];}
+    const Ship &operator[](int i) const {return ships[i];}
+    Ship *begin() {return ships;}
+    Ship *end() {return ships + numShips;}
+    const Ship *begin() const {return ships;}
+    const Ship *end() const {return ships + numShips;}
+};
+
+
+// Vectorized kernels AIOpponent uses to rebuild its density map and pick its
+// target. They work on arrays of 16-bit lanes holding one square each, in
+// Bitboard order and padded to a multiple of 16 lanes. Every set of kernels
+// computes the same result; GridKernels::Active() is the fastest one the CPU
+// supports unless another was chosen with Select.
+struct GridKernels{
+  const char *name;           // instruction set the kernels are written for
+  bool (*Supported)();        // true if the CPU can run the kernels
+  int rebuildLimit;           // changed squares beyond which AIOpponent rebuilds its 
+                              // density map rather than updating it square by square
+  // out[i] = bit i of words (0 or 1) for the first lanes lanes
+  void (*ExpandBits)(const uint64_t *words, int lanes, int16_t *out);
+  // Adds to density[i] the placements of size k counted at lane i that start
+  // at an EMPTY lane whose coord is in [minCoord, maxCoord] and step offset
+  // lanes per square over open interior lanes. open and fits need offset * (k - 2) 
+  // lanes of padding on both sides, and the padding of fits must be 0.
+  void (*AccumulateDirection)(int16_t *density, const int16_t *empty, const int16_t *open,
+                              const int16_t *coord, int lanes, int offset, int k,
+                              int minCoord, int maxCoord, int16_t *fits);
+  // Sets score[i] to 0 if fired[i], else adds weight[i] and 1000 if shotDown[i],
+  // then returns the first lane with the highest score
+  int (*ScoreTarget)(int16_t *score, const int16_t *weight, const int16_t *fired,
+                     const int16_t *shotDown, int lanes);
+  static const GridKernels all[];     // every set of kernels, fastest first
+  static const int numKernels;
+  static inline const GridKernels *active = nullptr;    // kernels chosen by Select
+  static const GridKernels &Active();
+  static bool Select(const string &name);
+};
+
+
+// Interface shared by every targeting algorithm the computer can fire with.
+// A strategy sees only what a player is told during the game: the targeting 
+// grid and which ships of the fleet it fires upon are still AFLOAT.
+// ChooseTarget returns the coordinates to fire at in the same form as 
+// Game::PromptFire (letter index, number index).
+template<class V>
+class BasicTargetingStrategy{
+  public:
+    virtual ~BasicTargetingStrategy() = default;
+    virtual pair<int, int> ChooseTarget(const BasicBoard<V> &grid,
+                                        const BasicFleet<V> &enemyFleet) = 0;
+    // Called before each game; strategies that use random numbers reseed here
+    virtual void NewGame(uint64_t /*seed*/) {}
+};
+
+
+// Size in bytes of the TranspositionTable every AIOpponent shares, set with
+// --tt-size before the first game starts. 0 turns the table off.
+inline size_t transpositionBytes = size_t(4) << 20;
+
+
+// Zobrist keys of variant V: a random 64-bit key for every state a square of
+// a targeting grid can be in other than EMPTY, and for every size the 
+// smallest ship AFLOAT can have. The hash of a grid is the XOR of the keys of
+// its squares, so a change to one square updates the hash with two XORs, and
+// the hash of a decision is that of its grid XOR the key of the smallest ship.
+// The keys are drawn from a fixed seed, so hashes are the same in every run.
+template<class V>
+struct ZobristKeys{
+  uint64_t square[V::maxSquares][6];        // square[i][state], 0 for EMPTY
+  uint64_t smallest[V::maxShipSize + 1];    // smallest[s], s being the smallest ship AFLOAT
+  ZobristKeys();
+  uint64_t Hash(const BasicBoard<V> &grid) const;
+};
+
+
+// Fixed-size table of decisions made by the AIOpponent, shared by every 
+// AIOpponent of variant V on every thread. Each entry holds the Zobrist hash
+// of a decision, the square chosen and the heatmap the choice was made from.
+// An entry is indexed by the low bits of its hash and simply replaced by the
+// next decision stored there.
+// No thread ever waits: each entry is a seqlock. A writer makes the entry's
+// sequence odd while it writes and gives up if another writer holds it; a
+// reader copies the entry and discards the copy if the sequence was odd or
+// changed meanwhile. Every field is a relaxed atomic, which compiles to plain
+// loads and stores.
+template<class V>
+class TranspositionTable{
+  private:
+    static constexpr int heatWords = (V::maxSquares + 3) / 4;   // heatmap words of 4 squares
+    struct alignas(64) Entry{
+      atomic<uint32_t> sequence{0};           // odd while the entry is being written
+      atomic<uint32_t> target{0};             // square chosen
+      atomic<uint64_t> key{0};                // hash of the decision, 0 if none
+      atomic<uint64_t> heatmap[heatWords];    // score of every square, 4 to a word
+    };
+    unique_ptr<Entry[]> entries;    // the table
+    size_t numEntries;              // power of two, 0 if the table is off
+  public:
+    static inline const ZobristKeys<V> keys;
+    // Makes a table of the largest power of two number of entries in bytes
+    explicit TranspositionTable(size_t bytes);
+    size_t Size() const {return numEntries;}
+    bool Probe(uint64_t key, int &target, int16_t heatmap[]) const;
+    void Store(uint64_t key, int target, const int16_t heatmap[]);
+    void Clear();
+    static TranspositionTable *Shared();
+};
+
+
+// Path of the opening book every AIOpponent consults, set with --book before
+// the first game starts. Empty for none.
+inline string openingBookPath;
+
+
+// Decisions of the AIOpponent on common hunt-phase grids (no HIT squares) of
+// the opening, built offline by BuildOpeningBook. The file is mapped into 
+// memory and searched in place, so opening a book costs nothing however 
+// large it is, and every process using it shares the same pages.
+// An opening book file holds:
+//   "BSOB", version 1, the most squares fired at on any grid in the book, 
+//   two zero bytes
+//   uint64  number of grids n
+//   the RecordFormat header of the variant (see EncodeFormat), padded with 
+//           zeros to a multiple of 8 bytes
+//   uint64  Zobrist hash of each decision, as a TranspositionTable keys it,
+//           in increasing order
+//   uint16  Bitboard index of the square chosen for each decision, in the
+//           same order
+template<class V>
+class OpeningBook{
+  private:
+    const uint8_t *data = nullptr;      // mapped file
+    size_t size = 0;                    // bytes in the file
+    const uint64_t *keys = nullptr;     // sorted hash of every decision
+    const uint16_t *targets = nullptr;  // square chosen for each of keys
+    size_t numEntries = 0;              // decisions in the book
+    int maxFired = 0;                   // most squares fired at on a grid in the book
+  public:
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    ~OpeningBook() {Close();}
+    bool Open(const string &path);
+    void Close();
+    bool Lookup(uint64_t key, int &target) const;
+    size_t Size() const {return numEntries;}
+    int getMaxFired() const {return maxFired;}
+    static const OpeningBook *Shared();
+};
+
+
+// Essential set of functions for running the targeting algorithm that competes 
+// against the human player. 
+// The AI only looks at a targeting grid and the fleet it is firing upon, so 
+// the same functions can fire on behalf of either Player.
+// Weights are hand tuned: +1 per placement, +100/+50 next to a HIT and +1000
+// on a SHOT_DOWN square.
+// The AI remembers the grid it last evaluated along with a density map of 
+// every ship placement that fits on it. On the next evaluation only the 
+// placements crossing squares that changed since then are updated.
+// The maps are kept in 16-bit lanes so that the GridKernels can rebuild them
+// and score the grid many squares at a time.
+// Opening decisions are also stored in a TranspositionTable under the 
+// Zobrist hash of the grid and the smallest ship AFLOAT, which is all a 
+// decision depends on. A grid seen before, by this AI or any other, is 
+// answered from the table without touching the density map. Later grids are
+// rarely seen twice, and skipping the update only makes the next one dearer,
+// so the table is left alone once cacheShots squares have been fired at.
+// The hash of the known grid is kept, so the hash of the next grid is found
+// from the squares that changed. The same hash finds the decision in the 
+// OpeningBook, which is looked up before either.
+template<class V>
+class BasicAIOpponent : public BasicTargetingStrategy<V>{
+  private:
+    using Bitboard = BasicBitboard<V>;
+    using Board = BasicBoard<V>;
+    using Ship = BasicShip<V>;
+    using Fleet = BasicFleet<V>;
+    using Tables = PlacementTables<V>;
+    static constexpr int numLanes = DensityPlacementTable<V>::numLanes;
+    static constexpr int cacheShots = 10;   // squares fired at after which cache is not used
+    static constexpr int padding = (V::maxShipSize - 2) * V::maxHeight;   // lanes read past either end by
+                                // GridKernels::AccumulateDirection
+    Board known;                // grid the density maps currently describe
+    uint64_t knownHash;         // Zobrist hash of known
+    int minSize;                // smallest ship size included in weight
+    TranspositionTable<V> *cache;   // table decisions are shared through, nullptr if none
+    long cacheProbes,           // decisions looked up in cache
+         cacheHits;             // decisions found there
+    const OpeningBook<V> *book; // book of opening decisions, nullptr if none
+    long bookProbes,            // decisions looked up in book
+         bookHits;              // decisions found there
+    int16_t density[V::maxShipSize - 1][numLanes];    // density[i - 2][Bitboard::Index(x, y)] =
+                                // placements of ships of size i counted at point (x,y)
+    int16_t weight[numLanes];   // sum of density for every size from minSize up
+    int16_t empty[numLanes];    // 1 on the EMPTY squares of the grid being rebuilt
+    int16_t open[padding + numLanes + padding];   // 1 on the squares that are not a MISS or SINK
+    int16_t fits[padding + numLanes + padding];   // placements found by AccumulateDirection
+    static int Lanes() {return (V::Squares() + 15) / 16 * 16;}
+    bool PlacementFits(const Board &grid, int p);
+    void AddPlacement(int p, int n);
+    void UpdateSquare(const Board &before, const Board &after, int i);
+    void RebuildDensity(const Board &grid);
+    void ExpandGrid(const Board &grid);
+    void AccumulateSize(int k, int16_t out[]);
+    int ScoreGrid(const Board &grid, const int16_t weights[], int16_t score[]);
+    void SetMinSize(int s);
+    void AddHitWeight(const Board &grid, int x, int y, int16_t tmp[]);
+  public:
+    // Starts with the precomputed density map of an empty grid
+    BasicAIOpponent() : density{}, weight{}, empty{}, open{}, fits{} {
+      knownHash = 0;
+      minSize = 2;
+      cache = TranspositionTable<V>::Shared();
+      cacheProbes = 0;
+      cacheHits = 0;
+      book = OpeningBook<V>::Shared();
+      bookProbes = 0;
+      bookHits = 0;
+      for(int i = 0; i < V::Squares(); i++){
+        weight[i] = 0;
+        for(int k = 0; k < V::maxShipSize - 1; k++){
+          density[k][i] = Tables::emptyDensity.density[k][i];
+          weight[i] += density[k][i];
+        }
+      }
+    } 
+    pair<int, int> ChooseTarget(const Board &grid, const Fleet &enemyFleet) override {
+      return EvaluateGrid(grid, SmallestShipAlive(enemyFleet));
+    } 
+    pair<int, int> EvaluateGrid(const Board &grid, int s);
+    void EvaluateBatch(const BasicBoardBatch<V> &batch, pair<int, int> targets[], 
+                       int16_t heatmaps[] = nullptr);
+    bool EvalUp(const Board &grid, int x, int y, int s);
+    bool EvalDown(const Board &grid, int x, int y, int s);
+    bool EvalRight(const Board &grid, int x, int y, int s);
+    bool EvalLeft(const Board &grid, int x, int y, int s);
+    int SmallestShipAlive(const Fleet &fleet);
+    void DisplayProbabilityGrid(const int16_t grid[]);
+    // Shares decisions through t instead, or through no table if t is nullptr
+    void setCache(TranspositionTable<V> *t) {cache = t;}
+    long getCacheProbes() const {return cacheProbes;}
+    long getCacheHits() const {return cacheHits;}
+    // Looks decisions up in b instead, or in no book if b is nullptr
+    void setBook(const OpeningBook<V> *b) {book = b;}
+    long getBookProbes() const {return bookProbes;}
+    long getBookHits() const {return bookHits;}
+    template<class> friend class BasicGame;
+};
+
+
+// Targeting algorithm that computes the actual probability of each square 
+// containing a ship. Every placement of the AFLOAT ships that agrees with the 
+// targeting grid is equally likely: ships may not overlap each other or any 
+// MISS or SINK square, and together they must cover every HIT and SHOT_DOWN 
+// square. The AI counts how often each square is occupied over those fleet
+// placements and fires at the square occupied most often.
+// When the number of fleet placements is small enough they are all enumerated
+// and the result is exact. Otherwise fleet placements are sampled at random,
+// stopping after maxSamples samples or budgetMicros microseconds, whichever
+// comes first, so a turn never stalls. If no sample agrees with the grid the 
+// heuristic AIOpponent decides instead.
+template<class V>
+class BasicMonteCarloAI : public BasicTargetingStrategy<V>{
+  private:
+    using Bitboard = BasicBitboard<V>;
+    using Board = BasicBoard<V>;
+    using Ship = BasicShip<V>;
+    using Fleet = BasicFleet<V>;
+    using Tables = PlacementTables<V>;
+    RandomGenerator generator;          // source of random fleet placements
+    BasicAIOpponent<V> fallback;        // used when no fleet placement can be found
+    int maxSamples,                     // most fleet placements sampled per decision
+        budgetMicros,                   // most time spent sampling per decision; 0 = no limit
+        enumerationLimit;               // largest search that is enumerated exactly
+    vector<Bitboard> candidates[V::maxShips];   // placements of each AFLOAT ship that avoid
+                                        // MISS and SINK squares, largest ship first
+    int numShips;                       // number of AFLOAT ships
+    long counts[V::maxSquares];         // times each square was occupied
+    long total;                         // fleet placements that agreed with the grid
+    void Enumerate(int ship, Bitboard occupied, Bitboard mustCover, Bitboard fired);
+    void Sample(Bitboard mustCover, Bitboard fired);
+    void Count(Bitboard occupied, Bitboard fired);
+  public:
+    explicit BasicMonteCarloAI(int samples = 20000, int budget = 1000);
+    pair<int, int> ChooseTarget(const Board &grid, const Fleet &enemyFleet) override;
+    void NewGame(uint64_t seed) override {generator.Seed(seed);}
+};
+
+
+// Log file written by a background thread.
+// Text streamed into the logger by a single thread (the thread playing the 
+// game) is copied into a lock-free ring buffer; a writer thread drains the 
+// buffer to the file when it fills past the high-water mark or when Flush is
+// called at the end of a game. The game thread only waits if the buffer is
+// completely full. The time and date of the logged events are formatted once
+// per second and reused.
+class GameLogger : public streambuf{
+  private:
+    static constexpr size_t capacity = 1 << 16;       // size of the ring buffer in bytes
+    static constexpr size_t highWater = capacity / 2; // buffered bytes that wake the writer
+    char ring[capacity];                // text waiting to be written to the file
+    atomic<size_t> head{0},             // bytes put into the ring so far
+                   tail{0};             // bytes written to the file so far
+    mutex lock;                         // guards pending and stopping
+    condition_variable wake;            // wakes the writer thread
+    bool pending = false,               // true once the writer has been asked to drain
+         stopping = false;              // true once the writer has been asked to exit
+    ofstream file;                      // file the writer thread drains to
+    thread writer;                      // background thread writing the file
+    time_t cachedSecond = -1;           // second the cached strings were formatted for
+    string cachedTime, cachedDate;      // time and date of cachedSecond
+    void Wake();
+    void WriterLoop();
+    void Drain();
+    void UpdateClock();
+  protected:
+    streamsize xsputn(const char *s, streamsize n) override;
+    int_type overflow(int_type c) override;
+    // Lines end with '\n' rather than flushing; see Flush
+    int sync() override {return 0;}
+  public:
+    GameLogger() = default;
+    GameLogger(const GameLogger &) = delete;
+    GameLogger &operator=(const GameLogger &) = delete;
+    ~GameLogger() {Close();}
+    bool Open(const string &path);
+    void Flush();
+    void Close();
+    bool IsOpen() const {return writer.joinable();}
+    const string &Time();
+    const string &Date();
+};
+
+
+// Grid size and fleet of the games stored in a game record file
+struct RecordFormat{
+  int width = 0, height = 0;    // grid size
+  vector<int> sizes;            // size of each ship of the fleet
+  bool operator==(const RecordFormat &f) const {
+    return width == f.width && height == f.height && sizes == f.sizes;
+  }
+  // Bits used to store one shot: the square fired at, the player who fired 
+  // and the result of the shot
+  int ShotBits() const {return 64 - __builtin_clzll(width * height - 1) + 3;}
+};
+
+
+// A shot stored in a game record
+struct RecordedShot{
+  int square;             // Bitboard index of the square fired at
+  Player player;          // player who fired
+  SquareState result;     // MISS, HIT, SINK or SHOT_DOWN
+};
+
+
+// One game of a record file as read by GameRecordReader. Nothing is decoded
+// until asked for; placements and shots point into the mapped file.
+struct RecordedGame{
+  uint64_t seed;              // seed the game was played with
+  Gametype gameType;          // Gametype the game was played with
+  Player winner;              // player who won the game
+  bool forfeited;             // true if the game ended by forfeit
+  Player forfeiter;           // player who forfeited it
+  int numShips;               // ships in each fleet
+  int numShots;               // shots fired by both players
+  int shotBits;               // bits used by each shot
+  int numSquares;             // squares of the grid
+  const uint8_t *placements;  // varint placement of every user ship, then every computer ship
+  const uint8_t *shots;       // numShots bit-packed shots
+  const uint8_t *end;         // first byte past the record
+  void Placements(int origin[], bool vertical[]) const;
+  RecordedShot Shot(int i) const;
+};
+
+
+// Append-only writer of a game record file. 
+// A record file starts with its RecordFormat followed by one record per game:
+//   varint  bytes in the rest of the record
+//   varint  seed
+//   byte    Gametype | winner << 2 | forfeited << 3 | forfeiter << 4, where 
+//           forfeited is 1 if the game ended by forfeit and forfeiter is 
+//           the player who gave it up
+//   varint  origin * 2 + vertical for each user ship, then each computer ship
+//   varint  number of shots
+//   shots   ShotBits() bits per shot, packed starting at the lowest bit:
+//           result code | player << 2 | square << 3
+// A standard 10x10 game takes about 110 bytes. Records are collected in 
+// memory and appended with a single write once a megabyte has built up, so
+// games may be recorded from several threads at once.
+class GameRecordWriter{
+  private:
+    static constexpr size_t flushBytes = 1 << 20;   // buffered bytes that trigger a write
+    int fd = -1;                // file descriptor of the record file
+    mutex lock;                 // guards buffer
+    vector<uint8_t> buffer;     // records not yet written to the file
+    RecordFormat format;        // format of every game in the file
+    void WriteBuffer();
+  public:
+    GameRecordWriter() = default;
+    GameRecordWriter(const GameRecordWriter &) = delete;
+    GameRecordWriter &operator=(const GameRecordWriter &) = delete;
+    ~GameRecordWriter() {Close();}
+    bool Open(const string &path, const RecordFormat &f);
+    void Append(const vector<uint8_t> &record);
+    void Close();
+    const RecordFormat &getFormat() const {return format;}
+    bool IsOpen() const {return fd >= 0;}
+};
+
+
+// Reader of a game record file. The file is mapped into memory and games
+// are read in place, so an archive larger than memory can be walked without
+// copying or parsing text.
+class GameRecordReader{
+  private:
+    const uint8_t *data = nullptr;    // mapped file
+    size_t size = 0;                  // bytes in the file
+    size_t offset = 0;                // position of the next record
+    RecordFormat format;              // format of every game in the file
+  public:
+    GameRecordReader() = default;
+    GameRecordReader(const GameRecordReader &) = delete;
+    GameRecordReader &operator=(const GameRecordReader &) = delete;
+    ~GameRecordReader() {Close();}
+    bool Open(const string &path);
+    bool Next(RecordedGame &game);
+    void Close();
+    const RecordFormat &getFormat() const {return format;}
+    bool AtEnd() const {return offset == size;}
+};
+
+
+// Text of one screen of the game composed into a single buffer and sent to 
+// the terminal with one write() instead of a stream call per symbol.
+// The buffer is kept between frames, so composing a frame does not allocate
+// once the first frame has been drawn.
+// In diff mode Draw keeps the whole screen at the top of the terminal and 
+// only sends the cells that differ from the frame drawn before, each run of 
+// changed cells preceded by an ANSI cursor address. This needs a terminal 
+// tall enough to hold the frame and the prompts below it without scrolling.
+class Screen{
+  private:
+    string frame;               // text composed since the last Write or Draw
+    string drawn;               // frame last drawn in diff mode
+    string out;                 // bytes sent to the terminal by Draw
+    vector<int> cells,          // byte offset of every cell of frame, line by line
+                lines,          // index in cells of the first cell of every line of frame
+                drawnCells,     // the same for drawn
+                drawnLines;
+    bool diff;                  // true if Draw only sends changed cells
+    bool onScreen;              // true if drawn is what the terminal shows
+    static void SplitCells(const string &text, vector<int> &cells, vector<int> &lines);
+    static void Send(ostream &display, const string &text);
+  public:
+    Screen() : diff(false), onScreen(false) {frame.reserve(1 << 14);}
+    void setDiff(bool d) {diff = d;}
+    bool getDiff() const {return diff;}
+    void Append(string_view text) {frame.append(text.data(), text.size());}
+    void Append(char c) {frame.push_back(c);}
+    void Append(int n, char c) {frame.append(n, c);}
+    void AppendNumber(int n, int width);
+    void AppendStruck(string_view text);
+    void Write(ostream &display);
+    void Draw(ostream &display);
+};
+
+
+// Phases of a game timed when compiled with -DBATTLESHIP_PROFILE.
+// PHASE_GAME is whatever time a game spends outside of the other phases.
+enum ProfilePhase{PHASE_GAME, PHASE_PLACEMENT, PHASE_PLAYER_TURN, PHASE_COMP_TURN, PHASE_AI, 
+                  PHASE_HIT, PHASE_RENDER, PHASE_LOG, PHASE_INPUT, NUM_PHASES};
+
+#ifdef BATTLESHIP_PROFILE
+// Calls and time counted for one phase by one thread.
+// Only the owning thread writes the counters; the thread printing a summary
+// reads them while they change, so they are atomics accessed relaxed, which 
+// compiles to plain loads and stores.
+struct PhaseCounters{
+  static const int numBuckets = 48;     // bucket k counts calls taking 2^k to 2^(k+1) ticks
+  atomic<uint64_t> calls{0},            // scopes of the phase that were timed
+                   ticks{0},            // time spent inside those scopes
+                   selfTicks{0},        // the same less the time spent in nested scopes
+                   maxTicks{0},         // longest single call
+                   buckets[numBuckets] = {};   // histogram of call durations
+};
+
+
+// Phase timings of one thread. Each thread counts into its own profile, 
+// which is merged into the totals of finished threads when the thread exits.
+// Print sums the profiles of every thread, running or finished.
+// Time is counted in ticks of the time stamp counter where there is one and
+// of steady_clock elsewhere.
+class ThreadProfile{
+  private:
+    PhaseCounters phases[NUM_PHASES];               // counters of this thread
+    static mutex lock;                              // guards live and retired
+    static vector<ThreadProfile *> live;            // profiles of running threads
+    static PhaseCounters retired[NUM_PHASES];       // totals of finished threads
+    static uint64_t startTicks;                     // tick count when Start was called
+    static chrono::steady_clock::time_point startTime;  // and the time it was called
+  public:
+    ThreadProfile();
+    ~ThreadProfile();
+    void Add(ProfilePhase phase, uint64_t ticks, uint64_t selfTicks);
+    static ThreadProfile &Current();
+    static uint64_t Now();
+    static void Start();
+    static void Print(ostream &out);
+};
+
+
+// Times the rest of the enclosing block as one call of the given phase.
+// Scopes nest: time spent in an inner scope is subtracted from the self time
+// of the scope around it, so the self times of every phase add up to the 
+// time spent in the outermost scopes.
+// A scope must end before the coroutine it is in suspends; otherwise scopes
+// of whatever runs while it is suspended would be counted as nested in it.
+class ProfileScope{
+  private:
+    ProfilePhase phase;                   // phase being timed
+    uint64_t start,                       // ticks when the scope was entered
+             childTicks;                  // ticks spent in nested scopes
+    ProfileScope *parent;                 // scope this one is nested in, nullptr if none
+    static thread_local ProfileScope *current;    // innermost scope of this thread
+  public:
+    explicit ProfileScope(ProfilePhase p) : phase(p), childTicks(0), parent(current){
+      current = this;
+      start = ThreadProfile::Now();
+    } 
+    ~ProfileScope();
+};
+
+#define PROFILE_CONCAT(a, b) a##b
+#define PROFILE_NAME(line) PROFILE_CONCAT(profileScope, line)
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_NAME(__LINE__)(phase)
+#else
+#define PROFILE_SCOPE(phase)
+#endif
+
+
+// Allocates the frames of the coroutines a game is played with. Freed frames
+// are kept on a list per thread and per size class (multiples of 64 bytes), 
+// so a game that suspends and resumes every turn reuses the same few frames
+// rather than going to the heap. Frames larger than the biggest class come
+// from the heap as usual.
+class FrameAllocator{
+  private:
+    static const size_t unit = 64;          // frame sizes are rounded up to a multiple of unit
+    static const int numClasses = 64;       // size classes kept, up to 4 KB
+    struct FreeFrame{
+      FreeFrame *next;                      // next free frame of the same size class
+    };
+    // Free frames of one thread, returned to the heap when the thread exits
+    struct FreeLists{
+      FreeFrame *heads[numClasses] = {};    // heads[c] = free frames of c units
+      ~FreeLists();
+    };
+    static thread_local FreeLists freeLists;
+    static inline atomic<long> bytesInUse{0},     // bytes of frames alive on every thread
+                               peakBytes{0};      // most bytes alive at once
+  public:
+    static void *Allocate(size_t size);
+    static void Free(void *p, size_t size);
+    static long getBytesInUse() {return bytesInUse.load(memory_order_relaxed);}
+    static long getPeakBytes() {return peakBytes.load(memory_order_relaxed);}
+};
+
+
+template<class T = void> class Task;
+
+
+// Part of the promise of a Task that does not depend on its result.
+// The coroutine is suspended until it is awaited or started, and once it 
+// finishes it resumes the coroutine awaiting it, if any, without growing the
+// stack.
+struct TaskPromiseBase{
+  coroutine_handle<> continuation;    // coroutine awaiting this one, null if none
+  struct FinalAwaiter{
+    bool await_ready() noexcept {return false;}
+    template<class P>
+    coroutine_handle<> await_suspend(coroutine_handle<P> h) noexcept {
+      coroutine_handle<> next = h.promise().continuation;
+      return next ? next : noop_coroutine();
+    }
+    void await_resume() noexcept {}
+  };
+  suspend_always initial_suspend() noexcept {return {};}
+  FinalAwaiter final_suspend() noexcept {return {};}
+  void unhandled_exception() {terminate();}
+  static void *operator new(size_t size) {return FrameAllocator::Allocate(size);}
+  static void operator delete(void *p, size_t size) {FrameAllocator::Free(p, size);}
+};
+
+
+template<class T>
+struct TaskPromise : TaskPromiseBase{
+  T value{};                          // value given to co_return
+  Task<T> get_return_object();
+  void return_value(T v) {value = move(v);}
+  T Result() {return move(value);}
+};
+
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase{
+  Task<void> get_return_object();
+  void return_void() {}
+  void Result() {}
+};
+
+
+// Coroutine returning a T that may suspend, such as a turn waiting for the
+// player's input. A Task is run by awaiting it from another Task, or by 
+// calling Start on the outermost one. Destroying a Task destroys its frame
+// and with it the frame of any Task it is suspended in.
+template<class T>
+class Task{
+  public:
+    using promise_type = TaskPromise<T>;
+    using Handle = coroutine_handle<promise_type>;
+  private:
+    Handle handle;    // frame of the coroutine, null once moved from
+  public:
+    explicit Task(Handle h = nullptr) : handle(h) {}
+    Task(Task &&t) noexcept : handle(exchange(t.handle, nullptr)) {}
+    Task &operator=(Task &&t) noexcept {
+      if(this != &t){
+        if(handle){
+          handle.destroy();
+        }
+        handle = exchange(t.handle, nullptr);
+      }
+      return *this;
+    }
+    ~Task() {
+      if(handle){
+        handle.destroy();
+      }
+    }
+    // Runs the coroutine until it first suspends
+    void Start() {handle.resume();}
+    bool Done() const {return !handle || handle.done();}
+    bool await_ready() const {return false;}
+    coroutine_handle<> await_suspend(coroutine_handle<> caller){
+      handle.promise().continuation = caller;
+      return handle;
+    }
+    T await_resume() {return handle.promise().Result();}
+};
+
+
+template<class T>
+Task<T> TaskPromise<T>::get_return_object() {return Task<T>(Task<T>::Handle::from_promise(*this));}
+
+inline Task<void> TaskPromise<void>::get_return_object() {return Task<void>(Task<void>::Handle::from_promise(*this));}
+
+
+// Lines of input handed to a coroutine that is waiting for them. The 
+// coroutine awaits Line(); whatever reads the input (the terminal or the 
+// game server) calls Push once a line has arrived, which resumes the 
+// coroutine until it waits again.
+class InputChannel{
+  private:
+    string line;                  // line not taken yet
+    bool ready = false;           // true while line has not been taken
+    coroutine_handle<> waiting;   // coroutine suspended in Line(), null if none
+  public:
+    struct LineAwaiter{
+      InputChannel &channel;      // channel the line is taken from
+      bool await_ready() const {return channel.ready;}
+      void await_suspend(coroutine_handle<> h) {channel.waiting = h;}
+      string await_resume() {
+        channel.ready = false;
+        return move(channel.line);
+      }
+    };
+    LineAwaiter Line() {return LineAwaiter{*this};}
+    // Hands over the next line, resuming the coroutine waiting for it
+    void Push(string l){
+      line = move(l);
+      ready = true;
+      if(waiting){
+        exchange(waiting, nullptr).resume();
+      }
+    }
+    bool IsWaiting() const {return bool(waiting);}
+};
+
+
+// Told of every shot a Game resolves, once the grids show its result.
+// result is MISS, HIT, SINK or SHOT_DOWN; shipLoc is the index of the ship
+// on the square in the fleet fired at, or -1 if there is none.
+class ShotObserver{
+  public:
+    virtual ~ShotObserver() = default;
+    virtual void ShotFired(Player p, int tarCol, int tarRow, SquareState result, int shipLoc) = 0;
+};
+
+
+// Extensive class which manages a vast majority of game functionality
+// * Handles all persistent grids and ships belonging to the player and computer
+// * Handles writing/recording actions to a log file with the current date 
+//   and/or time
+// * Manages the Gametype selected and all subsequent function changes resulting 
+//   from the given Gametype
+// * Displays all necessary output for the game to run
+// * Takes input from the user in order to place ships and target squares on the 
+//   grid(s)
+// A Game constructed as non-interactive neither prints nor writes log.txt 
+// (unless given a GameLogger) and is played to completion by AutoPlay.
+// A finished game is Reset to play the next one in place, keeping its log, 
+// targeting algorithm and recorder.
+// The grid size and fleet are those of variant V.
+template<class V>
+class BasicGame{
+  private:
+    using Bitboard = BasicBitboard<V>;
+    using Board = BasicBoard<V>;
+    using Ship = BasicShip<V>;
+    using Fleet = BasicFleet<V>;
+    using TargetingStrategy = BasicTargetingStrategy<V>;
+    using Tables = PlacementTables<V>;
+    Gamestate gameState;              // Helps keep track of what is currently happening in the game
+    Gametype gameType;                // Determines what aspects of the game will be enabled/disabled
+    unique_ptr<GameLogger> ownLog;    // log.txt of an interactive game
+    GameLogger *log;                  // Logger the game is recorded to, nullptr if none
+    ostream file;                     // Stream every log entry is written to
+    ostream display;                  // Stream all game output is printed to; discards 
+                                      // everything when the game is not interactive
+    RandomGenerator generator;        // Random number generator owned by this game only
+    Board userShips;                  // Grid showing where the player's ships are
+    Board playerTargeting;            // Grid showing where the player has fired
+    Board compShips;                  // Grid showing where the computer's ships are
+    Board compTargeting;              // Grid showing where the computer has fired
+    Fleet userFleet;                  // Container of all ships belonging to the player
+    Fleet compFleet;                  // Container of all ships belonging to the computer
+    int userAfloat,                   // Bit i is set while userFleet[i] is AFLOAT
+        compAfloat;                   // Bit i is set while compFleet[i] is AFLOAT
+    BasicAIOpponent<V> arty;          // Computer opponent
+    int8_t shipIndex[2][V::maxSquares];   // shipIndex[p][i] is the index in Player p's fleet of 
+                                          // the ship on square i, or -1 if there is none
+    TargetingStrategy *compAI;        // Targeting algorithm the computer fires with (arty by default)
+    GameRecordWriter *recorder;       // File the finished game is recorded to, nullptr if none
+    ShotObserver *observer;           // Told of every shot resolved, nullptr if none
+    vector<uint16_t> recordedShots;   // shots fired so far, encoded as in the record file
+    int forfeiter;                    // Player who forfeited the game, -1 if none
+    const RecordedShot *replayShot;   // shot being replayed, which decides if it is shot down
+    Screen screen;                    // grids are composed here before being displayed
+  public:
+    // Initializes a new game with the given Gametype
+    // The game's random number generator is seeded with seed, so games never 
+    // share random state and can be played on separate threads. Playing with
+    // the same seed (and the same user input) reproduces a game exactly.
+    // Non-interactive games leave log.txt untouched
+    explicit BasicGame(Gametype gt, bool interactive = true, uint64_t seed = NewSeed())
+        : log(nullptr), file(nullptr), display(interactive ? cout.rdbuf() : nullptr), 
+          generator(seed){
+      gameState = WAITING;
+      gameType = gt;
+      if(interactive){
+        //Specification B2 - Log file to Disk
+        ownLog.reset(new GameLogger());
+        if(ownLog->Open("log.txt")){
+          setLogger(ownLog.get());
+        }
+      }
+      userAfloat = 0;
+      compAfloat = 0;
+      compAI = &arty;
+      recorder = nullptr;
+      observer = nullptr;
+      replayShot = nullptr;
+      forfeiter = -1;
+      memset(shipIndex, -1, sizeof(shipIndex));
+    } 
+    void Reset(Gametype gt, uint64_t seed);
+    void Detach();
+    void Initialize();
+    bool NewGameMenu();
+    void ConstructFleets();
+    Task<> Play(InputChannel &input);
+    Task<> PlayerTurn(InputChannel &input);
+    void CompTurn();
+    int AITurn(Player p, TargetingStrategy &ai);
+    Player AutoPlay(TargetingStrategy &userAI, int &shotsToWin);
+    // Begins play once both fleets are placed, for callers that play the turns themselves
+    void Start() {gameState = PLAYING;}
+    // Replaces the computer's targeting algorithm; ai must outlive the game
+    void setCompStrategy(TargetingStrategy *ai) {compAI = ai;}
+    // Records the game to the open logger l; l must outlive the game
+    void setLogger(GameLogger *l) {log = l; file.rdbuf(l);}
+    // Records the game to r once it is over; r must outlive the game and 
+    // hold games of variant V
+    void setRecorder(GameRecordWriter *r) {recorder = r;}
+    // Tells o of every shot resolved; o must outlive the game
+    void setObserver(ShotObserver *o) {observer = o;}
+    // Prints all game output to sb instead; sb must outlive the game
+    void setDisplay(streambuf *sb) {display.rdbuf(sb);}
+    // Redraws only the changed cells of the turn screen when d is true
+    void setDiffRender(bool d) {screen.setDiff(d);}
+    void CheckHit(pair <int, int> target, Player p);
+    void ShipHit(int tarCol, int tarRow, Player p);
+    int GetShip(pair<int, int> coords, Player p);
+    bool IsFleetDestroyed(Player p);
+    Task<pair<int, int> > PromptFire(InputChannel &input);
+    void PromptTarget();
+    bool TakeTarget(const string &input, pair<int, int> &target);
+    void DrawTurn();
+    int ShotsPerTurn(Player p);
+    bool CheckWin(Player p);
+    void Forfeit(Player p);
+    void RandomPlacement(Player p);
+    bool RandomPlace(int shipLoc,Player p);
+    void ManualPlacement();
+    bool CheckDirection(int d, int x, int y, int s);
+    bool CheckUp(int x, int y, int s);
+    bool CheckDown(int x, int y, int s);
+    bool CheckLeft(int x, int y, int s);
+    bool CheckRight(int x, int y, int s);
+    int DirectionMenu(int x, int y, int shipSize);
+    void PromptPlacement(int shipLoc);
+    void DisplayGrid(const Board &grid, Player p);
+    void PlaceShip(int shipLoc, Player p);
+    bool ShootDownMissile();
+    void LogStart();
+    void LogGameType();
+    void LogShipPlace(int shipLoc, Player p);
+    void LogFire(int tarCol, int tarRow, Player p);
+    void LogHit();
+    void LogMiss();
+    void LogShotDown();
+    void LogDamage(int shipLoc, Player p);
+    void LogSink(int shipLoc, Player p);
+    void LogWin(Player p);
+    void LogExit();
+    void RecordShot(int tarCol, int tarRow, Player p);
+    void SaveRecord(Player winner);
+    bool Replay(const RecordedGame &record, string &divergence);
+    bool PlaceRecordedShip(int shipLoc, Player p, int origin, bool vertical);
+    void RenderGrid(const Board &grid, Player p);
+    void RenderMargin(char fill);
+    void PrintShipP1(int shipLoc, char margin);
+    void PrintShipP2(int shipLoc, char margin);
+    void SinkShip(int shipLoc, Player p);
+    int NumShipsAlive(Player p);
+    const Fleet &getFleet(Player p) const {return p == USER ? userFleet : compFleet;}
+    const Board &getTargeting(Player p) const {return p == USER ? playerTargeting : compTargeting;}
+    const Board &getShips(Player p) const {return p == USER ? userShips : compShips;}
+    Gametype getGametype() const {return gameType;}
+    uint64_t getSeed() const {return generator.getSeed();}
+    Gamestate getGamestate() const {return gameState;}
+    uint64_t getRandomDraws() const {return generator.getDraws();}
+    template<class> friend class BasicAIOpponent;
+};
+
+
+// Non-interactive games kept ready to be played, so that simulation workers 
+// and servers never construct a game while playing.
+// Acquire hands out an idle game Reset to the given Gametype and seed, 
+// constructing a new one only if every game is checked out. Release detaches
+// the game's logger, recorder and targeting algorithm and returns it to the
+// pool. Both may be called from any thread.
+template<class V>
+class BasicGamePool{
+  private:
+    mutex lock;                                   // guards idle
+    vector<unique_ptr<BasicGame<V> > > idle;      // games waiting to be acquired
+  public:
+    // Constructs the pool with numGames games ready to be acquired
+    explicit BasicGamePool(int numGames = 0);
+    unique_ptr<BasicGame<V> > Acquire(Gametype gt, uint64_t seed);
+    void Release(unique_ptr<BasicGame<V> > game);
+};
+
+
+// The standard game's classes
+using Bitboard = BasicBitboard<Classic>;
+using Board = BasicBoard<Classic>;
+using Ship = BasicShip<Classic>;
+using Fleet = BasicFleet<Classic>;
+using TargetingStrategy = BasicTargetingStrategy<Classic>;
+using AIOpponent = BasicAIOpponent<Classic>;
+using BoardBatch = BasicBoardBatch<Classic>;
+using MonteCarloAI = BasicMonteCarloAI<Classic>;
+using Game = BasicGame<Classic>;
+using GamePool = BasicGamePool<Classic>;
+
+
+// Settings for a batch of AI vs AI games played by RunSimulation
+struct SimulationOptions{
+  long numGames = 0;              // number of games to play per Gametype
+  int numThreads = 1;             // number of worker threads
+  uint64_t seed = 0;              // seed of the first game; game n is seeded with seed + n
+  string userAI = "heuristic";    // targeting strategy firing on the player's behalf
+  string compAI = "heuristic";    // targeting strategy the computer fires with
+  int samples = 20000;            // MonteCarloAI samples per decision
+  int budgetMicros = 1000;        // MonteCarloAI time limit per decision in microseconds
+  string logPath;                 // worker n logs its games to logPath.n when given
+  GameRecordWriter *recorder = nullptr;   // every game is recorded to recorder when given
+};
+
+
+// Results gathered from a batch of AI vs AI games played by RunSimulation
+struct SimulationStats{
+  long games = 0;               // number of games played
+  long userWins = 0;            // games won by the AI firing on the player's behalf
+  long compWins = 0;            // games won by the computer
+  long totalShots = 0;          // sum of the winner's shots over every game
+  vector<long> shotsToWin;      // shotsToWin[n] = number of games won in n shots
+  double seconds = 0;           // wall clock time spent playing
+  uint64_t seed = 0;            // seed of the first game; game n was seeded with seed + n
+  uint64_t randomDraws = 0;     // random numbers drawn over every game
+  void Record(Player winner, int shots);
+  void Merge(const SimulationStats &other);
+};
+
+
+// Queue of game batches belonging to one simulation worker thread.
+// The owning worker takes batches from the front of its queue; a worker whose
+// queue has run dry steals batches from the back of another worker's queue.
+// Each batch is a range of game numbers [first, last).
+class WorkQueue{
+  private:
+    mutex lock;                           // guards batches
+    deque<pair<long, long> > batches;     // ranges of games still to be played
+  public:
+    void Push(pair<long, long> batch);
+    bool Pop(pair<long, long> &batch);
+    bool Steal(pair<long, long> &batch);
+};
+
+
+// Timing of one benchmark, reported per operation
+struct BenchmarkResult{
+  string name;          // name of the benchmark, function/argument
+  long iterations;      // operations timed
+  double realNs;        // wall clock nanoseconds per operation
+  double cpuNs;         // CPU nanoseconds per operation spent by the benchmarking thread
+};
+
+
+// Handed to the body of a benchmark, which performs getIterations() 
+// operations while the timer runs. Setup needed between operations is left
+// out of the timing by pausing the timer around it.
+class BenchmarkState{
+  private:
+    long iterations;                              // operations the body must perform
+    double realSeconds,                           // wall clock time counted so far
+           cpuSeconds;                            // CPU time counted so far
+    chrono::steady_clock::time_point realStart;   // when the timer was last resumed
+    double cpuStart;                              // CPU time when the timer was last resumed
+    bool running;                                 // true while the timer runs
+    static double CpuNow();
+  public:
+    explicit BenchmarkState(long n) 
+        : iterations(n), realSeconds(0), cpuSeconds(0), cpuStart(0), running(false) {}
+    long getIterations() const {return iterations;}
+    void ResumeTiming();
+    void PauseTiming();
+    double getRealSeconds() const {return realSeconds;}
+    double getCpuSeconds() const {return cpuSeconds;}
+};
+
+
+// Stream buffer that discards everything written to it, so output can be 
+// formatted at full speed without reaching the terminal
+class NullBuffer : public streambuf{
+  protected:
+    int overflow(int c) override {return c == EOF ? 0 : c;}
+    streamsize xsputn(const char * /*s*/, streamsize n) override {return n;}
+};
+
+
+// Keeps the compiler from discarding a benchmarked result that is never used
+template<class T>
+inline void KeepResult(const T &value){
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+
+// Stream buffer that appends everything written to it to a string, so the
+// output of a game played over a socket can be sent when the socket is ready
+class StringBuffer : public streambuf{
+  private:
+    string &text;     // string the output is appended to
+  protected:
+    int overflow(int c) override {
+      if(c != EOF){
+        text.push_back(char(c));
+      }
+      return c == EOF ? 0 : c;
+    }
+    streamsize xsputn(const char *s, streamsize n) override {text.append(s, n); return n;}
+  public:
+    explicit StringBuffer(string &t) : text(t) {}
+};
+
+
+// Settings of the game server and of the load test run against it
+struct ServerOptions{
+  int port = 7525;                // TCP port on the loopback interface, 0 for none
+  string unixPath;                // path of a Unix socket to listen on as well, if given
+  uint64_t seed = 0;              // seed of the first game; every game is seeded one higher
+  int maxSessions = 20000;        // connections beyond this are refused
+  int connections = 0;            // load test: connections held open at once
+  double seconds = 10;            // load test: how long to keep playing
+  Gametype gameType = CLASSIC;    // load test: Gametype every connection plays
+};
+
+
+// One player connected to the GameServer: the connection, the bytes waiting
+// to be handled or sent on it, and the game being played. The session is 
+// played by a coroutine that is suspended whenever it waits for a line from
+// the player. The game prints into output, which is sent whenever the socket
+// can take it.
+template<class V>
+struct BasicSession{
+  int fd;                                 // connection to the player
+  string input;                           // bytes received that do not end a line yet
+  string output;                          // bytes waiting to be sent
+  size_t sent = 0;                        // bytes of output already sent
+  uint32_t events = EPOLLIN;              // events epoll watches the connection for
+  StringBuffer display{output};           // the game's display
+  unique_ptr<BasicGame<V> > game;         // game being played, nullptr while choosing
+  InputChannel lines;                     // complete lines handed to flow
+  Task<> flow;                            // coroutine playing the session
+  explicit BasicSession(int f) : fd(f) {}
+};
+
+
+// Event driven server playing a Game with every connected player.
+// A single thread waits on epoll for any socket to become readable or 
+// writable, so no thread ever blocks on one player. Every socket is 
+// non-blocking; input is split into lines and handed to the session's 
+// coroutine, which runs until it needs the next line, and whatever the game
+// prints is sent back as the socket drains. A suspended session only holds
+// its coroutine frames, which are recycled by the FrameAllocator. Players 
+// speak the same text as the interactive game: the name of a Gametype starts
+// a game with randomly placed fleets, and coordinates fire at the computer.
+// Every response ends with a prompt ending in '?'.
+// A player who sends lines without reading the responses is not allowed to
+// make the server buffer them: once maxPending bytes of output wait to be 
+// sent, the session's lines are left unplayed and its socket is not read 
+// until the output drains below that again.
+template<class V>
+class BasicGameServer{
+  private:
+    using Session = BasicSession<V>;
+    static constexpr size_t maxPending = 64 << 10;    // bytes of input or output buffered per session
+    ServerOptions options;
+    int epollFd;                              // epoll instance every socket is registered with
+    vector<int> listeners;                    // listening sockets
+    vector<unique_ptr<Session> > sessions;    // sessions[fd] = session of connection fd
+    BasicGamePool<V> pool;                    // games handed out to the sessions
+    uint64_t nextSeed;                        // seed of the next game started
+    long numSessions = 0,                     // connections open now
+         peakSessions = 0,                    // most connections open at once
+         gamesStarted = 0,                    // games started by every session
+         turnsPlayed = 0;                     // turns completed by every session
+    static inline volatile sig_atomic_t stopping = 0;   // set by SIGINT and SIGTERM
+    bool AddListener(int fd);
+    void Accept(int listener);
+    void Receive(Session &s);
+    void Send(Session &s);
+    bool Feed(Session &s);
+    Task<> Serve(Session &s);
+    void Close(Session &s);
+  public:
+    explicit BasicGameServer(const ServerOptions &o);
+    ~BasicGameServer();
+    bool Open();
+    void Run();
+};
+
+
+// One connection of the load test and the game it is playing
+struct LoadConnection{
+  int fd = -1;                              // connection to the server
+  string input;                             // response received so far
+  vector<int> order;                        // squares in the order they are fired at
+  size_t next = 0;                          // next square of order to fire at
+  bool playing = false;                     // true once a game was started
+  bool waiting = false;                     // true while the response to a target is expected
+  chrono::steady_clock::time_point sentAt;  // when the last line was sent
+};
+
+
+// Game played through the C interface of battleship.h, in memory owned by
+// the caller. Each shot the game resolves is copied to the results array of
+// the call that fired it and reported to the caller's callback.
+// BasicEngineGame plays the game with the variant chosen by the bs_config.
+class EngineGame : public ShotObserver{
+  protected:
+    bs_shot_callback callback = nullptr;    // told of every shot, nullptr if none
+    void *context = nullptr;                // passed back to callback
+    bs_shot *results = nullptr;             // shots of the turn being played go here, if given
+    int numResults = 0;                     // shots resolved in the turn being played
+    Player toMove = USER;                   // side whose turn it is
+  public:
+    void setCallback(bs_shot_callback cb, void *c) {callback = cb; context = c;}
+    void ShotFired(Player p, int tarCol, int tarRow, SquareState result, int shipLoc) override;
+    virtual void Reset(Gametype gt, uint64_t seed) = 0;
+    virtual bool Place(Player p, int shipLoc, int row, int column, bool vertical) = 0;
+    virtual bool PlaceRandom(Player p) = 0;
+    virtual bool Start() = 0;
+    virtual int Fire(const bs_target targets[], int count, bs_shot out[]) = 0;
+    virtual int CompTurn(bs_shot out[]) = 0;
+    virtual bool Forfeit(Player p) = 0;
+    virtual void Status(bs_status &status) const = 0;
+    virtual int Grid(int grid, uint8_t cells[]) const = 0;
+};
+
+
+template<class V>
+class BasicEngineGame : public EngineGame{
+  private:
+    BasicGame<V> game;    // non-interactive game being played
+  public:
+    BasicEngineGame(Gametype gt, uint64_t seed) : game(gt, false, seed){
+      game.setObserver(this);
+      game.ConstructFleets();
+    }
+    void Reset(Gametype gt, uint64_t seed) override;
+    bool Place(Player p, int shipLoc, int row, int column, bool vertical) override;
+    bool PlaceRandom(Player p) override;
+    bool Start() override;
+    int Fire(const bs_target targets[], int count, bs_shot out[]) override;
+    int CompTurn(bs_shot out[]) override;
+    bool Forfeit(Player p) override;
+    void Status(bs_status &status) const override;
+    int Grid(int grid, uint8_t cells[]) const override;
+};
+
+
+//function prototypes
+void ProgramGreeting();
+Gametype MainMenu();
+template<class V> int Main(int argc, char *argv[]);
+template<class V> string VariantName();
+bool ParseBoard(const string &str, int &width, int &height);
+bool ParseFleet(const string &str, vector<int> &fleet);
+template<class V> bool EvalDirection(const BasicBoard<V> &grid, int d, int x, int y, int s);
+template<class V> SimulationStats RunSimulation(Gametype gt, const SimulationOptions &options);
+template<class V> void SimulationWorker(Gametype gt, const SimulationOptions &options, int id,
+                                        vector<WorkQueue> &queues, BasicGamePool<V> &pool, 
+                                        SimulationStats &stats);
+template<class V> void PrintSimulationReport(Gametype gt, const SimulationOptions &options,
+                                             const SimulationStats &stats);
+template<class V> unique_ptr<BasicTargetingStrategy<V> > NewStrategy(const string &name, int samples,
+                                                                     int budgetMicros);
+bool ParseGametype(const string &str, Gametype &gt);
+const char *GametypeName(Gametype gt);
+const char *ResultName(SquareState s);
+double RandomCost();
+template<class V> bool RunPlacementTest(long numFleets, uint64_t seed);
+template<class V> int BuildOpeningBook(const string &path, long numGames, int maxFired, uint64_t seed);
+double ChiSquareP(double chiSquare, int dof);
+void PutVarint(vector<uint8_t> &out, uint64_t value);
+bool GetVarint(const uint8_t *&p, const uint8_t *end, uint64_t &value);
+vector<uint8_t> EncodeFormat(const RecordFormat &f);
+size_t DecodeFormat(const uint8_t *p, size_t n, RecordFormat &f);
+template<class V> RecordFormat VariantFormat();
+int PrintRecordStats(const string &path);
+template<class V> int RunReplay(const string &path, int numThreads);
+template<class V> int RunBenchmarks(double minSeconds, const string &filter, const string &jsonPath);
+template<class F> BenchmarkResult RunBenchmark(const string &name, double minSeconds, F body);
+bool WriteBenchmarkJson(const string &path, const string &board, double minSeconds,
+                        const vector<BenchmarkResult> &results);
+bool RunAtTerminal(Task<> task, InputChannel &input);
+void RaiseFileLimit();
+template<class V> int RunServer(const ServerOptions &options);
+template<class V> int RunLoadTest(const ServerOptions &options);
+
+
+
+// Runs an interactive game of battleship.
+// battleship --record-stats <file>
+//   reads every game of a game record file and prints a summary of it
+// battleship [--board WxH] [--fleet sizes] [options]
+//   plays on a grid of W columns by H rows (default 10x10) with a fleet of
+//   ships of the given comma separated sizes (default 5,4,3,3,2). The standard
+//   fleet on a 10x10, 15x15 or 20x20 grid uses a variant compiled for that
+//   grid; anything else up to 26x26 with up to 10 ships of size 2-8 is played
+//   with the RuntimeVariant. --replay uses the grid and fleet stored in the
+//   record file instead. --kernels avx2|sse4.1|scalar picks the GridKernels
+//   the heuristic AI runs on (default: the fastest the CPU supports). 
+//   --tt-size MB sizes the TranspositionTable the heuristic AIs share 
+//   (default 4, 0 for none). --book file has them consult the opening book
+//   in file, built with --build-book. The remaining options are handled by 
+//   Main.
+// Left out when the program is built as a library with -DBATTLESHIP_LIBRARY.
+#ifndef BATTLESHIP_LIBRARY
+int main(int argc, char *argv[]) {
+#ifdef BATTLESHIP_PROFILE
+  ThreadProfile::Start();
+#endif
+  if(argc == 3 && string(argv[1]) == "--record-stats"){
+    return PrintRecordStats(argv[2]);
+  }
+  int width = 10, height = 10;                                // grid size given on the command line
+  vector<int> fleet(ClassicFleet::sizes, ClassicFleet::sizes + ClassicFleet::numShips);
+  vector<char *> args;                                        // arguments left for Main
+  bool valid = true;                                          // bool to ensure valid arguments
+  for(int i = 0; i < argc; i++){
+    string arg = argv[i];
+    if(arg == "--board" && i + 1 < argc){
+      valid = valid && ParseBoard(argv[++i], width, height);
+    } 
+    else if(arg == "--fleet" && i + 1 < argc){
+      valid = valid && ParseFleet(argv[++i], fleet);
+    } 
+    else if(arg == "--kernels" && i + 1 < argc){
+      valid = valid && GridKernels::Select(argv[++i]);
+    } 
+    else if(arg == "--tt-size" && i + 1 < argc){
+      int megabytes = atoi(argv[++i]);   // size of the table in MB
+      valid = valid && megabytes >= 0 && megabytes <= 65536;
+      transpositionBytes = size_t(megabytes) << 20;
+    } 
+    else if(arg == "--book" && i + 1 < argc){
+      openingBookPath = argv[++i];
+    } 
+    else if(arg == "--replay" && i + 1 < argc){
+      // A replay is played on the board and fleet the file was recorded with
+      GameRecordReader reader;
+      if(reader.Open(argv[i + 1])){
+        width = reader.getFormat().width;
+        height = reader.getFormat().height;
+        fleet = reader.getFormat().sizes;
+      }
+      args.push_back(argv[i]);
+    } 
+    else{
+      args.push_back(argv[i]);
+    } 
+  }
+  args.push_back(nullptr);
+  bool classicFleet = fleet == vector<int>(ClassicFleet::sizes, ClassicFleet::sizes + ClassicFleet::numShips);
+  if(valid && classicFleet && width == 10 && height == 10){
+    return Main<Classic>(args.size() - 1, args.data());
+  }
+  if(valid && classicFleet && width == 15 && height == 15){
+    return Main<Classic15>(args.size() - 1, args.data());
+  }
+  if(valid && classicFleet && width == 20 && height == 20){
+    return Main<Classic20>(args.size() - 1, args.data());
+  }
+  if(!valid || !RuntimeVariant::Configure(width, height, fleet)){
+    cerr << "usage: " << argv[0] << " [--board WxH] [--fleet size,size,...] [--kernels name]"
+         << " [--tt-size MB] [--book file] [options]"
+         << "\n  grids from 5x5 to 26x26; 1 to 10 ships of size 2 to 8 that fit on the grid"
+         << " and cover at most half of it" << endl;
+    return 1;
+  }
+  return Main<RuntimeVariant>(args.size() - 1, args.data());
+}
+#endif
+
+
+// Runs the program with the grid size and fleet of variant V.
+// battleship [--seed s] [--ai heuristic|montecarlo] [--record file] [--render full|diff]
+//   seeds the first game with s, replaying any game whose seed was logged, 
+//   and selects the computer's targeting algorithm. Finished games are 
+//   appended to the game record file given with --record. With --render diff
+//   the turn screen stays at the top of the terminal and only the squares 
+//   that changed are redrawn.
+// battleship --simulate <games> [classic|multifire|cruise|hardcore] [--threads n] [--seed s]
+//            [--user-ai name] [--comp-ai name] [--samples n] [--budget us] [--log file]
+//            [--record file]
+//   plays the given number of AI vs AI games with no user input and reports 
+//   the results. Every Gametype is simulated when none is given. Games are 
+//   split across n threads (default: one per core). Game number i is seeded 
+//   with s + i. Each side can use either targeting algorithm; --samples and 
+//   --budget limit the work the montecarlo AI does per shot. With --log, 
+//   thread n writes the log of every game it plays to file.n. With --record,
+//   every game is appended to the given game record file.
+// battleship --replay <file> [--threads n]
+//   replays every game of a game record file on n threads (default: one per
+//   core), checking each one against its record, and reports the first game
+//   that did not play out as recorded. Exits with 1 if any game diverged.
+// battleship --placement-test <fleets> [--seed s]
+//   randomly places the given number of fleets and checks that every ship was
+//   drawn uniformly from the placements open to it. Exits with 1 on failure.
+// battleship --build-book <file> [--games n] [--depth d] [--seed s]
+//   plays n openings (default 100000) of up to d shots (default 20) of the 
+//   heuristic AI against randomly placed fleets, seeded from s, and writes
+//   the hunt-phase decisions taken in more than one of them to an opening 
+//   book file for --book.
+// battleship --benchmark [--min-time s] [--filter text] [--json file]
+//   times the engine's hot paths and complete games of every Gametype, 
+//   running each benchmark for at least s seconds (default 0.5). Only the 
+//   benchmarks whose name contains text are run. --json also writes the 
+//   results to file in the JSON format of google-benchmark.
+// battleship --serve [--port p] [--unix path] [--seed s] [--max-sessions n]
+//   serves games to any number of players over TCP on 127.0.0.1:p (default
+//   7525, 0 for none) and/or a Unix socket from one thread, until SIGINT.
+// battleship --load-test <connections> [classic|multifire|cruise|hardcore] 
+//            [--port p | --unix path] [--seconds s] [--seed s]
+//   plays games on the given number of connections to a server for s seconds
+//   (default 10) and reports the p50 and p99 turn latency. Exits with 1 if 
+//   the server could not be reached or hung up.
+template<class V>
+int Main(int argc, char *argv[]) {
+  if(!openingBookPath.empty() && !OpeningBook<V>::Shared()){
+    cerr << openingBookPath << " is not an opening book for " << VariantName<V>() << endl;
+    return 1;
+  }
+  if(argc > 1 && string(argv[1]) == "--build-book"){
+    long numGames = 100000;                               // openings to play
+    int depth = 20;                                       // shots fired in each opening
+    uint64_t seed = 1;                                    // seed of the first opening
+    bool valid = argc > 2;                                // bool to ensure valid arguments
+    for(int i = 3; i < argc; i++){
+      string arg = argv[i];
+      if(arg == "--games" && i + 1 < argc){
+        numGames = atol(argv[++i]);
+        valid = valid && numGames > 0;
+      }
+      else if(arg == "--depth" && i + 1 < argc){
+        depth = atoi(argv[++i]);
+        valid = valid && depth > 0 && depth <= min(V::Squares(), 255);
+      }
+      else if(arg == "--seed" && i + 1 < argc){
+        seed = strtoull(argv[++i], nullptr, 10);
+      }
+      else{
+        valid = false;
+      }
+    }
+    if(!valid){
+      cerr << "usage: " << argv[0] << " --build-book <file> [--games n] [--depth d] [--seed s]" << endl;
+      return 1;
+    }
+    return BuildOpeningBook<V>(argv[2], numGames, depth, seed);
+  }
+  if(argc > 1 && string(argv[1]) == "--placement-test"){
+    long numFleets = argc > 2 ? atol(argv[2]) : 0;        // fleets to place
+    uint64_t seed = NewSeed();                            // seed of the first fleet
+    if(argc == 5 && string(argv[3]) == "--seed"){
+      seed = strtoull(argv[4], nullptr, 10);
+    } 
+    if(numFleets <= 0 || (argc != 3 && argc != 5)){
+      cerr << "usage: " << argv[0] << " --placement-test <fleets> [--seed s]" << endl;
+      return 1;
+    } 
+    return RunPlacementTest<V>(numFleets, seed) ? 0 : 1;
+  }
+  if(argc > 1 && string(argv[1]) == "--replay"){
+    int numThreads = thread::hardware_concurrency();    // number of worker threads
+    if(argc == 5 && string(argv[3]) == "--threads"){
+      numThreads = atoi(argv[4]);
+    }
+    if(numThreads <= 0 || (argc != 3 && argc != 5)){
+      cerr << "usage: " << argv[0] << " --replay <file> [--threads n]" << endl;
+      return 1;
+    }
+    return RunReplay<V>(argv[2], numThreads);
+  }
+  if(argc > 1 && string(argv[1]) == "--benchmark"){
+    double minSeconds = 0.5;        // least time each benchmark runs for
+    string filter,                  // only benchmarks whose name contains filter are run
+           jsonPath;                // file the results are written to as JSON
+    bool valid = true;              // bool to ensure valid arguments
+    for(int i = 2; i < argc; i++){
+      string arg = argv[i];
+      if(arg == "--min-time" && i + 1 < argc){
+        minSeconds = atof(argv[++i]);
+        valid = valid && minSeconds > 0;
+      }
+      else if(arg == "--filter" && i + 1 < argc){
+        filter = argv[++i];
+      }
+      else if(arg == "--json" && i + 1 < argc){
+        jsonPath = argv[++i];
+      }
+      else{
+        valid = false;
+      }
+    }
+    if(!valid){
+      cerr << "usage: " << argv[0] << " --benchmark [--min-time s] [--filter text] [--json file]" << endl;
+      return 1;
+    }
+    return RunBenchmarks<V>(minSeconds, filter, jsonPath);
+  }
+  if(argc > 1 && (string(argv[1]) == "--serve" || string(argv[1]) == "--load-test")){
+    ServerOptions options;                                // settings given on the command line
+    bool serving = string(argv[1]) == "--serve",          // false for the load test
+         valid = true;                                    // bool to ensure valid arguments
+    options.seed = NewSeed();
+    int first = 2;                                        // first option after the mode
+    if(!serving){
+      options.connections = argc > 2 ? atoi(argv[2]) : 0;
+      valid = options.connections > 0;
+      first = 3;
+    }
+    for(int i = first; i < argc; i++){
+      string arg = argv[i];
+      if(arg == "--port" && i + 1 < argc){
+        options.port = atoi(argv[++i]);
+        valid = valid && options.port >= 0 && options.port < 65536;
+      }
+      else if(arg == "--unix" && i + 1 < argc){
+        options.unixPath = argv[++i];
+        options.port = serving ? options.port : 0;
+      }
+      else if(arg == "--seed" && i + 1 < argc){
+        options.seed = strtoull(argv[++i], nullptr, 10);
+      }
+      else if(arg == "--max-sessions" && i + 1 < argc && serving){
+        options.maxSessions = atoi(argv[++i]);
+        valid = valid && options.maxSessions > 0;
+      }
+      else if(arg == "--seconds" && i + 1 < argc && !serving){
+        options.seconds = atof(argv[++i]);
+        valid = valid && options.seconds > 0;
+      }
+      else if(serving || !ParseGametype(arg, options.gameType)){
+        valid = false;
+      }
+    }
+    if(!valid){
+      cerr << "usage: " << argv[0] << " --serve [--port p] [--unix path] [--seed s] [--max-sessions n]"
+           << "\n       " << argv[0] << " --load-test <connections> [classic|multifire|cruise|hardcore]"
+           << " [--port p | --unix path] [--seconds s] [--seed s]" << endl;
+      return 1;
+    }
+    return serving ? RunServer<V>(options) : RunLoadTest<V>(options);
+  }
+  if(argc > 1 && string(argv[1]) == "--simulate"){
+    SimulationOptions options;                            // settings given on the command line
+    Gametype gt = CLASSIC;                                // Gametype given on the command line
+    options.numGames = argc > 2 ? atol(argv[2]) : 0;
+    options.numThreads = thread::hardware_concurrency();
+    options.seed = NewSeed();
+    string recordPath;                                    // record file given on the command line
+    bool allTypes = true,                                 // true if no Gametype was given
+         valid = options.numGames > 0;                    // bool to ensure valid arguments
+    for(int i = 3; i < argc; i++){
+      string arg = argv[i];
+      if(arg == "--threads" && i + 1 < argc){
+        options.numThreads = atoi(argv[++i]);
+        valid = valid && options.numThreads > 0;
+      }
+      else if(arg == "--seed" && i + 1 < argc){
+        options.seed = strtoull(argv[++i], nullptr, 10);
+      }
+      else if(arg == "--user-ai" && i + 1 < argc){
+        options.userAI = argv[++i];
+        valid = valid && NewStrategy<V>(options.userAI, 1, 0) != nullptr;
+      }
+      else if(arg == "--comp-ai" && i + 1 < argc){
+        options.compAI = argv[++i];
+        valid = valid && NewStrategy<V>(options.compAI, 1, 0) != nullptr;
+      }
+      else if(arg == "--samples" && i + 1 < argc){
+        options.samples = atoi(argv[++i]);
+        valid = valid && options.samples > 0;
+      }
+      else if(arg == "--budget" && i + 1 < argc){
+        options.budgetMicros = atoi(argv[++i]);
+        valid = valid && options.budgetMicros >= 0;
+      }
+      else if(arg == "--log" && i + 1 < argc){
+        options.logPath = argv[++i];
+      }
+      else if(arg == "--record" && i + 1 < argc){
+        recordPath = argv[++i];
+      }
+      else if(ParseGametype(arg, gt)){
+        allTypes = false;
+      }
+      else{
+        valid = false;
+      }
+    } 
+    if(!valid){
+      cerr << "usage: " << argv[0] 
+           << " --simulate <games> [classic|multifire|cruise|hardcore] [--threads n] [--seed s]" 
+           << "\n       [--user-ai heuristic|montecarlo] [--comp-ai heuristic|montecarlo]"
+           << " [--samples n] [--budget us] [--log file] [--record file]" << endl;
+      return 1;
+    } 
+    GameRecordWriter recorder;    // record file every simulated game is appended to
+    if(!recordPath.empty()){
+      if(!recorder.Open(recordPath, VariantFormat<V>())){
+        cerr << "Could not open " << recordPath << " as a record file for this board and fleet" << endl;
+        return 1;
+      }
+      options.recorder = &recorder;
+    } 
+    for(int type = CLASSIC; type <= HARDCORE; type++){
+      if(allTypes || type == gt){
+        PrintSimulationReport<V>(Gametype(type), options, RunSimulation<V>(Gametype(type), options));
+      }
+    } 
+    return 0;
+  }
+
+  uint64_t seed = NewSeed();                                  // seed of the next game
+  unique_ptr<BasicTargetingStrategy<V> > compAI;              // replaces the computer's AI if given
+  GameRecordWriter recorder;                                  // record file finished games are appended to
+  bool diffRender = false;                                    // redraw only the changed cells of each turn
+  for(int i = 1; i + 1 < argc; i += 2){
+    string arg = argv[i];
+    if(arg == "--seed"){
+      seed = strtoull(argv[i + 1], nullptr, 10);
+    } 
+    else if(arg == "--ai"){
+      compAI = NewStrategy<V>(argv[i + 1], 20000, 1000);
+    } 
+    else if(arg == "--render"){
+      diffRender = string(argv[i + 1]) == "diff";
+    } 
+    else if(arg == "--record" && !recorder.Open(argv[i + 1], VariantFormat<V>())){
+      cerr << "Could not open " << argv[i + 1] << " as a record file for this board and fleet" << endl;
+      return 1;
+    } 
+  }
+  ProgramGreeting();
+  bool playing = true;    // bool to enable continued play
+
+  BasicGame<V> game(MainMenu(), true, seed);    // played again after a Reset for every round
+  if(compAI){
+    game.setCompStrategy(compAI.get());
+  } 
+  if(recorder.IsOpen()){
+    game.setRecorder(&recorder);
+  }
+  game.setDiffRender(diffRender);
+  while(playing){
+    if(compAI){
+      compAI->NewGame(seed);
+    } 
+    seed++;
+    game.Initialize();
+    InputChannel input;     // lines typed while the game is played
+    if(!RunAtTerminal(game.Play(input), input) || !game.NewGameMenu()){
+      playing = false;
+    } 
+    else{
+      game.Reset(MainMenu(), seed);
+    }
+  }
+
+  return 0;
+}
+
+
+//ProgramGreeting - USE ENLARGED TERMINAL WINDOW
+void ProgramGreeting(){
+  cout << " __________    _________________________________    ___________ _________ ___ ___ ______________" << endl
+       << " \\______   \\  /  _  \\__    ___/\\__    ___/|    |    \\_   _____//   _____//   |   \\|   \\______   \\ " << endl
+       << "  |    |  _/ /  /_\\  \\|    |     |    |   |    |     |    __)_ \\_____  \\/    ~    \\   ||     ___/ " << endl
+       << "  |    |   \\/    |    \\    |     |    |   |    |___  |        \\/        \\    Y    /   ||    |    " <<endl
+       << "  |________/\\____|____/____|     |____|   |________\\/_________/_________/\\___|___/|___||____|" << endl
+       << "\nWelcome to BATTLESHIP, a classic game of wit and strategy."
+       << " In this game, you will be pitted against the best battleship player"
+       << " known to humankind: a computer. Good luck and godspeed." << endl
+       << "\nPress Enter to Continue";
+  // Waits for the user to press enter. Ignores all other input.
+  {
+    PROFILE_SCOPE(PHASE_INPUT);
+    cin.ignore(numeric_limits<streamsize>::max(),'\n');
+  }
+}
+
+
+// Prompts the user the select a Gametype through use of a numeric menu
+// returns the Gametype selected
+Gametype MainMenu(){
+  Gametype gT = CLASSIC;    // initialized gametype to be returned
+  int input;                // input from user
+  bool valid = false;       // bool to ensure valid entry
+  while(!valid){
+    cout << "\n___________________"
+         << "\n| SELECT GAME TYPE \\" 
+         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+         << "\n1. Classic"
+         << "\n2. Multifire"
+         << "\n3. Cruise Missiles"
+         << "\n4. Hardcore"
+         << "\n5. Game Type Descriptions"
+         << "\n6. Exit" 
+         << endl;
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      cin >> input;
+    }
+    cin.clear();
+    cin.ignore( 256, '\n' );
+    switch(input) {
+      case 1: gT = CLASSIC;
+        valid = true;
+        break;
+      // Specification A2 - MultiFire Game
+      case 2: gT = MULTIFIRE;
+        valid = true;
+        break;
+      // Specification A3 - Cruise Missiles
+      case 3: gT = CRUISE_MISSILES;
+        valid = true;
+        break;
+      case 4: gT = HARDCORE;
+        valid = true;
+        break;
+      case 5:
+      {
+        cout << "\nCLASSIC - The name says it all. Place your ships in the water"
+             << "and attempt to locate where the enemy placed their ships."
+             << "Each player gets to fire once per turn. First one to sink all"
+             << "of the opponent's ships wins." << endl
+             << "\nMULTIFIRE - Classic, but with a twist. Each player gets to "
+             << "fire once for each ship afloat in their fleet." << endl
+             << "\nCRUISE MISSILES - Yet another take on the original, this game"
+             << "type takes a more modern perspective. In this mode ships have "
+             << "an 80% chance to shoot down incoming missiles." << endl
+             << "\nHARDCORE - Absolute mayhem. Combines all of the features of"
+             << "the previous game types into one explosive package." << endl;
+        break;
+      }
+      case 6:
+      {
+        cout << "Goodbye!" << endl;
+        exit(0);
+      }
+      // Bulletproof - prevents all entries other than numbers 1-6
+      default: cout << "\nInvalid entry, please enter a number from 1 through 6"
+                    << "(no decimals)." << endl;
+        break;
+    }
+  }
+  return gT;
+}
+
+
+// Prints the SquareState of a Square to the stream os.
+// Each state is represented by a symbol.
+void Square::Print(ostream &os){
+  os << getSymbol();
+}
+
+
+/*
+  Below exists all functions for class Game.
+  The amount of code is extensive, however it has been divided up logically
+  in order to enhance readability.
+
+  SECTION 1: PLACEMENT
+  SECTION 2: PLAY
+  SECTION 3: LOG
+*/
+
+/*
+  SECTION 1: PLACEMENT
+
+  This section deals with the initialization of the game and the placement of ships,
+  both random and manual, for both the computer and the user.
+*/
+
+
+// Returns the game to the state it was constructed in, with the Gametype gt
+// and the random number generator seeded with seed, so that it can be played
+// again. The logger, the computer's targeting algorithm and the recorder 
+// stay attached. Only the grids, the fleets and the ship map are cleared, 
+// which is far cheaper than constructing a new game.
+template<class V>
+void BasicGame<V>::Reset(Gametype gt, uint64_t seed){
+  gameState = WAITING;
+  gameType = gt;
+  generator.Seed(seed);
+  userShips.Clear();
+  playerTargeting.Clear();
+  compShips.Clear();
+  compTargeting.Clear();
+  userFleet.Clear();
+  compFleet.Clear();
+  userAfloat = 0;
+  compAfloat = 0;
+  memset(shipIndex, -1, sizeof(shipIndex));
+  recordedShots.clear();
+  replayShot = nullptr;
+  forfeiter = -1;
+}
+
+
+// Removes the logger, the recorder, the observer, the display and any 
+// targeting algorithm given to the game, leaving it as a non-interactive game
+// would be constructed
+template<class V>
+void BasicGame<V>::Detach(){
+  setLogger(nullptr);
+  setDisplay(nullptr);
+  compAI = &arty;
+  recorder = nullptr;
+  observer = nullptr;
+}
+
+
+// Initializes the game by calling for the cration of all needed ships
+// Prompts the user for what type of placement they wish to use for their
+// fleet.
+template<class V>
+void BasicGame<V>::Initialize(){
+  LogStart();
+  LogGameType();
+  ConstructFleets();
+  
+  bool choiceMade = false;    // ensures valid input
+  int input;                  // input from user
+  while(!choiceMade){
+    display << "\n___________________"
+         << "\n| SELECT PLACEMENT \\"
+         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+         << "\n1. Random Placement"
+         << "\n2. Manual Placement"
+         << "\n3. Exit" 
+         << endl;
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      cin >> input;
+    }
+    cin.clear();
+    cin.ignore( 256, '\n' );
+    switch(input) {
+      case 1: { 
+        RandomPlacement(USER);
+        choiceMade = true;
+        break;
+      }
+      case 2: { 
+        ManualPlacement();
+        choiceMade = true;
+        break;
+      }
+      case 3: {
+        display << "Goodbye!" << endl;
+        LogExit();
+        exit(0);
+      }
+      //Bulletproof - Does not accept inputs other than 1,2, or 3
+      default: display << "\nInvalid entry, please enter either 1, 2, or 3." 
+                    << endl;
+        break;
+    }
+  }
+  RandomPlacement(COMP);
+}
+
+
+//constructs the ships of variant V's fleet for both players
+template<class V>
+void BasicGame<V>::ConstructFleets(){
+userFleet.Clear();
+for(int i = 0; i < V::NumShips(); i++){
+  userFleet.Add(Ship(V::ShipSize(i), V::ShipName(i)));
+}
+
+compFleet.Clear();
+for(int i = 0; i < V::NumShips(); i++){
+  compFleet.Add(Ship(V::ShipSize(i), V::ShipName(i)));
+}
+
+userAfloat = (1 << userFleet.getNumShips()) - 1;
+compAfloat = (1 << compFleet.getNumShips()) - 1;
+}
+
+
+//loops through the fleet belonging to Player p, randomly places each ship
+// A crowded custom fleet can leave a ship with no room left; the whole fleet
+// is then cleared and placed again. This never happens with the standard fleet.
+template<class V>
+void BasicGame<V>::RandomPlacement(Player p){
+  PROFILE_SCOPE(PHASE_PLACEMENT);
+  int numShips = getFleet(p).getNumShips();    // number of ships to place
+  bool placed = false;                  // true once every ship found room
+  while(!placed){
+    placed = true;
+    if(p == USER){
+      userShips = Board();
+      for(int i = 0; i < numShips && placed; i++){
+        placed = RandomPlace(i, p);
+      }
+    }
+    else{
+      compShips = Board();
+      // Specification B3 - Random Start
+      for(int i = 0; i < numShips && placed; i++){
+        placed = RandomPlace(i, p);
+      }
+    }
+  }
+}
+
+
+// Randomly places the ship at index location shipLoc on the grid
+// Every placement of the ship that covers no occupied square is listed from the
+// ShipPlacementTable and one of them is drawn uniformly, so a ship is placed 
+// with a single random draw however crowded the grid is. It takes one mask 
+// test per placement the table holds for the ship's size, first[k + 1] - 
+// first[k] for size k: 180 for a ship of size 2 on the 10x10 grid, and 
+// never more than ShipPlacementTable<V>::numPlacements.
+// Returns false if no placement of the ship is left.
+template<class V>
+bool BasicGame<V>::RandomPlace(int shipLoc, Player p){
+  Board &ships = (p == USER) ? userShips : compShips;               // grid the ship is placed on
+  Ship &ship = (p == USER) ? userFleet[shipLoc] : compFleet[shipLoc];
+  short legal[ShipPlacementTable<V>::numPlacements];              // placements that fit on the grid
+  int numLegal = LegalPlacements<V>(~ships.getMask(EMPTY), ship.getSize(), legal);
+  if(numLegal == 0){
+    return false;
+  }
+  ship.setMask(Tables::ship.masks[legal[generator.Below(numLegal)]]);
+  PlaceShip(shipLoc, p);
+  LogShipPlace(shipLoc, p);
+  return true;
+}
+
+
+// Loops through all of the ships in the userFleet and prompts for placement
+template<class V>
+void BasicGame<V>::ManualPlacement(){
+  PROFILE_SCOPE(PHASE_PLACEMENT);
+  for(int i = 0; i < userFleet.getNumShips(); i++){
+      PromptPlacement(i);
+    }
+}
+
+
+// Prompts the user for placement coordinates and desired direction.
+// Checks if the placement is valid, then places the ship if it is. 
+// Reprompts if it isn't.
+template<class V>
+void BasicGame<V>::PromptPlacement(int shipLoc){
+  SquareState tmpSS;                                // temporary SquareState variable to be used 
+                                                    // for comparison
+  pair<int, int> origin;                            // target coordinates to be returned
+  string input;                                     // string input from the user
+  int inX,                                          // integer conversion from the user's input
+      inY;                                          // integer conversion from the user's input
+  bool valid = false,                               // bool to ensure valid entry
+       isNum;                                       // boot to ensure that second half of input 
+                                                    // is a number
+  vector<pair<int,int> > shipVec;                   // container of coordinates of where the given 
+                                                    // ship will be placed
+  int shipSize = userFleet[shipLoc].getSize();    // size of the given ship
+  size_t maxLength = 1 + to_string(V::Width()).length();    // length of the longest coordinates
+
+  while(!valid){
+    DisplayGrid(userShips, USER);
+    display << "\nWhere would you like to place your " 
+         << userFleet[shipLoc].getName() 
+         << " (ex: C5)?";
+    cin.clear();
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      getline(cin, input);
+    }
+    //Bulletproof - checks to ensure input is of valid length
+    if(input.length() > maxLength){
+      display << "\nInvalid entry. The correct format is format for entry is"
+           << " LetterNumber, with no decimals (ex: C5)." 
+           << endl;
+    }
+    else{
+      //Bulletproof - check to ensure that second half of input is a number
+      isNum = true;
+      for(int i = 1; i < input.length(); i++){
+        if(!isdigit(input[i])){
+          isNum = false;
+        }
+      }
+      // Bulletproof
+      if(!isalpha(input[0]) || !isNum){
+         display << "\nInvalid entry. The correct format is format for entry is"
+              << " LetterNumber, with no decimals (ex: C5)." 
+              << endl;
+      }
+      else{
+        // Bulletproof - handles both upper and lowercase letters
+        // Conversions from ASCII chars to integers
+        if(!isupper(input[0])){
+          inX = (int)input[0] - 97;
+        }
+        else{
+          inX = (int)input[0] - 65;
+        }
+        inY = stoi(input.substr(1,input.length() - 1)) - 1; 
+        if(inX >= V::Height() || inX < 0 || inY >= V::Width() || inY < 0){
+          display << "\nInvalid entry, those coordinates are off the grid!" 
+               << endl;
+        }
+        else{
+          tmpSS = userShips.getSquareState(inY, inX);
+          if(tmpSS != EMPTY){
+            display << "\nInvalid entry, you have already placed a ship there!" 
+                 << endl;
+          }
+          else {
+            // Prompts for direction then fills a vector with the relevant coordinates
+            int dir = DirectionMenu(inY, inX, shipSize);
+            switch(dir){
+              case 1:
+              {
+                for(int i = inY; i < inY + shipSize; i++){
+                  shipVec.push_back(make_pair(i, inX));
+                }
+                valid = true;
+                break;
+              }
+              case 2:
+              {
+                for(int i = inX; i < inX + shipSize; i++){
+                  shipVec.push_back(make_pair(inY, i));
+                }
+                valid = true;
+                break;
+              }
+              case 3:
+              {
+                for(int i = inY; i > inY - shipSize; i--){
+                  shipVec.push_back(make_pair(i, inX));
+                }
+                valid = true;
+                break;
+              }
+              case 4:
+              {
+                for(int i = inX; i > inX - shipSize; i--){
+                  shipVec.push_back(make_pair(inY, i));
+                }
+                valid = true;
+                break;
+              }
+              case 99: break;
+            }
+          }
+        }
+      }
+    }
+  }
+  display << "PLACING";
+  // Places ship at relevant locations
+  userFleet[shipLoc].setCoords(shipVec.data());
+  PlaceShip(shipLoc, USER);
+  LogShipPlace(shipLoc, USER);
+}
+
+
+// Menu for prompting for direction. Returns an int representing a direction.
+// 1 = right; 2 = down; 3 = left; 4 = up
+// returns 99 if user wishes to go back
+template<class V>
+int BasicGame<V>::DirectionMenu(int x, int y, int shipSize){
+  int input,                // user input
+        dir;                // direction to be returned
+  bool validDir = false;    // bool to ensure valid direction
+  string err = "\n Cannot place a ship in that direction!";
+  while(!validDir){
+    display << "\n___________________"
+         << "\n| SELECT DIRECTION \\" 
+         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+         << "\n1. Right"
+         << "\n2. Down"
+         << "\n3. Left"
+         << "\n4. Up"
+         << "\n5. Re-enter coordinates" 
+         << endl;
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      cin >> input;
+    }
+    cin.clear();
+    cin.ignore( 256, '\n' );
+    // checks if given input is valid, sets dir equal to appropriate value
+    switch(input) {
+      case 1: 
+      { 
+        if(CheckRight(x, y, shipSize)){
+          dir = 1;
+          validDir = true;
+        }
+        else{
+          display << err << endl;
+        }
+        break;
+      }
+      case 2: 
+      { 
+        if(CheckDown(x, y, shipSize)){
+          dir = 2;
+          validDir = true;
+        }
+        else{
+          display << err << endl;
+        }
+        break;
+      }
+      case 3: 
+      { 
+        if(CheckLeft(x, y, shipSize)){
+          dir = 3;
+          validDir = true;
+        }
+        else{
+          display << err << endl;
+        }
+        break;
+      }
+      case 4: 
+      { 
+        if(CheckUp(x, y, shipSize)){
+          dir = 4;
+          validDir = true;
+        }
+        else{
+          display << err << endl;
+        }
+        break;
+      }
+      case 5: 
+      { 
+        dir = 99;
+        validDir = true;
+        break;
+      }
+      //Bulletproof - Does not accept inputs other than 1-5;
+      default: display << "\nInvalid entry, please enter a number 1-5 (no decimals)." 
+                    << endl;
+        break;
+    }
+  }
+  return dir;
+}
+
+// The Check functions are the placement versions of AIOpponent's Eval functions:
+// the squares between (x,y) and the far end of the ship must be EMPTY on the 
+// player's grid. Each check is a lookup in the DensityPlacementTable.
+template<class V>
+bool BasicGame<V>::CheckDirection(int d, int x, int y, int s){
+  int p = Tables::density.at[d][s][Bitboard::Index(x, y)];    // placement in the table
+  return p >= 0 && !(Tables::density.interior[p] & ~userShips.getMask(EMPTY)).Any();
+}
+
+//Checks to see if a ship of size 's' can fit vertically above point (x,y)
+template<class V>
+bool BasicGame<V>::CheckUp(int x, int y, int s){
+  return CheckDirection(0, x, y, s);
+}
+
+//Checks to see if a ship of size 's' can fit vertically below point (x,y)
+template<class V>
+bool BasicGame<V>::CheckDown(int x, int y, int s){
+  return CheckDirection(1, x, y, s);
+}
+
+//Checks to see if a ship of size 's' can fit horizontally left of point (x,y)
+template<class V>
+bool BasicGame<V>::CheckLeft(int x, int y, int s){
+  return CheckDirection(2, x, y, s);
+}
+
+//Checks to see if a ship of size 's' can fit horizontally right of point (x,y)
+template<class V>
+bool BasicGame<V>::CheckRight(int x, int y, int s){
+  return CheckDirection(3, x, y, s);
+}
+
+
+// Puts ship shipLoc of Player p's fleet on the grid at the coordinates it 
+// was given with setCoords: the SquareState of each of its squares is 
+// changed to SHIP and the squares are mapped to shipLoc for GetShip.
+template<class V>
+void BasicGame<V>::PlaceShip(int shipLoc, Player p){
+  Bitboard shipMask = getFleet(p)[shipLoc].getMask();    // set of squares the ship occupies
+  if(p == USER){
+    userShips.setSquares(shipMask, SHIP);
+  }
+  else{
+    compShips.setSquares(shipMask, SHIP);
+  }
+  while(shipMask.Any()){
+    shipIndex[p][shipMask.LowestBit()] = shipLoc;
+    shipMask.ClearLowestBit();
+  }
+}
+
+
+/*
+  SECTION 2: PLAY
+
+  The following code deals with the actual playing of the game. 
+  All functions in section 2 are executed while the user is playing.
+*/
+
+
+// Outlines what happens in the course of playing the game.
+// Each side takes a turn, with the user always going first.
+// After each side takes a turn, the game checks to see if either
+// has won.
+// After both turns are concluded, the game waits for the enter
+// key to be pressed, giving the player time to analyze what occurred.
+// The game suspends whenever it waits for a line of input, which is 
+// given to it through input.
+template<class V>
+Task<> BasicGame<V>::Play(InputChannel &input){
+  gameState = PLAYING;
+  while(gameState == PLAYING){
+    //DisplayGrid(compTargeting); //uncomment for debugging
+    co_await PlayerTurn(input);
+    if(CheckWin(USER) || CheckWin(COMP)) {
+      break;
+    }
+    else {
+      CompTurn();
+      CheckWin(COMP);
+    }
+    display << "\nPress Enter to Continue";
+    co_await input.Line();
+  }
+}
+
+
+// Outlines everything that occurs during a players turn.
+// 1. Grids showing the locations of the player's ships and locations of the 
+//    player's shots are displayed.
+// 2. Checks what Gametype is selected. 
+//    If MULTIFIRE or HARDCORE have been chosen, a targetList is generated by 
+//    prompting the player a number of times equal to the number of ships they 
+//    have alive.
+//    If niether of those Gametypes are active, the user is prompted for only 
+//    one target.
+// 3. For each target prompted for, the target coordinates are checked to see
+//    if the resulting impact is a HIT, MISS, or if the missile was SHOT_DOWN.
+// Only the shots are timed as PHASE_PLAYER_TURN, since a scope may not be 
+// held while the turn waits for input.
+template<class V>
+Task<> BasicGame<V>::PlayerTurn(InputChannel &input){
+  DrawTurn();
+  if(gameType == MULTIFIRE || gameType == HARDCORE){
+    pair<int, int> targetList[V::maxShips];   // container for up to several targetting solutions
+    int numShips = NumShipsAlive(USER);       // number of ships the player has AFLOAT
+    for(int i = 0; i < numShips; i++){
+      targetList[i] = co_await PromptFire(input);
+    }
+    PROFILE_SCOPE(PHASE_PLAYER_TURN);
+    for(int i = 0; i < numShips; i++){
+      CheckHit(targetList[i], USER);
+    }
+  }
+  else{
+    pair<int, int> target = co_await PromptFire(input);   // coordinates to fire at
+    PROFILE_SCOPE(PHASE_PLAYER_TURN);
+    CheckHit(target, USER);
+  }
+}
+
+
+// Displays the grids showing the locations of the player's ships and of the 
+// player's shots at the start of a turn
+template<class V>
+void BasicGame<V>::DrawTurn(){
+  screen.Append("\n___________________"
+                "\n| YOUR SHIPS       \\"
+                "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯\n");
+  RenderGrid(userShips, USER);
+  screen.Append("\n___________________"
+                "\n| TARGETTING GRID  \\"
+                "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯\n");
+  RenderGrid(playerTargeting, COMP);
+  screen.Append("\n(Type ff to forfeit.)\n");
+  screen.Draw(display);
+}
+
+
+// Returns the number of shots Player p fires this turn: one per ship AFLOAT
+// in MULTIFIRE and HARDCORE, otherwise one
+template<class V>
+int BasicGame<V>::ShotsPerTurn(Player p){
+  return (gameType == MULTIFIRE || gameType == HARDCORE) ? NumShipsAlive(p) : 1;
+}
+
+
+// Outlines everything that occurs during the computer's turn.
+template<class V>
+void BasicGame<V>::CompTurn(){
+  PROFILE_SCOPE(PHASE_COMP_TURN);
+  AITurn(COMP, *compAI);
+}
+
+
+// Takes a turn for Player p using the targeting algorithm of ai.
+// 1. Checks what Gametype is selected. 
+//    If MULTIFIRE or HARDCORE have been chosen, a targetList is generated by 
+//    evaluating Player p's targeting grid a number of times equal to the number 
+//    of ships Player p has alive 
+//    If niether of those Gametypes are active, the grid is only evaluated once.
+// 2. For each target evaluated, the target coordinates are checked to see
+//    if the resulting impact is a HIT, MISS, or if the missile was SHOT_DOWN.
+// Returns the number of shots fired.
+template<class V>
+int BasicGame<V>::AITurn(Player p, TargetingStrategy &ai){
+  Board &targeting = (p == USER) ? playerTargeting : compTargeting;     // grid the AI fires upon
+  const Fleet &enemyFleet = (p == USER) ? compFleet : userFleet;  // fleet the AI fires at
+  pair<int, int> aiTarget;              // firing solution to be generated by the AI's grid evaluation
+  if(gameType == MULTIFIRE || gameType == HARDCORE){
+    pair<int, int> targetList[V::maxShips];   // container for up to several targetting solutions
+    int numShips = NumShipsAlive(p);    // number of ships Player p has AFLOAT
+    for(int i = 0; i < numShips; i++){
+      aiTarget = ai.ChooseTarget(targeting, enemyFleet);
+      targeting.setSquareState(aiTarget.second, aiTarget.first, MISS);
+      targetList[i] = aiTarget;
+    }
+    for(int i = 0; i < numShips; i++){
+      CheckHit(targetList[i], p);
+    }
+    return numShips;
+  }
+  aiTarget = ai.ChooseTarget(targeting, enemyFleet);
+  CheckHit(aiTarget, p);
+  return 1;
+}
+
+
+// Plays a complete game without any user input: both fleets are placed 
+// randomly, then userAI fires on the player's behalf and the computer fires 
+// as usual until one side wins. The player always fires first.
+// Both targeting strategies are reseeded from the game's seed.
+// shotsToWin is set to the number of shots fired by the winner.
+// Returns the Player who won.
+template<class V>
+Player BasicGame<V>::AutoPlay(TargetingStrategy &userAI, int &shotsToWin){
+  PROFILE_SCOPE(PHASE_GAME);
+  int userShots = 0,    // shots fired by userAI
+      compShots = 0;    // shots fired by the computer
+  userAI.NewGame(getSeed());
+  compAI->NewGame(~getSeed());
+  LogStart();
+  LogGameType();
+  ConstructFleets();
+  RandomPlacement(USER);
+  RandomPlacement(COMP);
+  gameState = PLAYING;
+  while(true){
+    userShots += AITurn(USER, userAI);
+    if(CheckWin(USER)){
+      shotsToWin = userShots;
+      return USER;
+    }
+    compShots += AITurn(COMP, *compAI);
+    if(CheckWin(COMP)){
+      shotsToWin = compShots;
+      return COMP;
+    }
+  }
+}
+
+
+// Checks the given player/comp's afloat mask to see if every ship is SUNK
+// returns true if all ships are SUNK, false if at least one ship is AFLOAT
+template<class V>
+bool BasicGame<V>::IsFleetDestroyed(Player p){
+  return (p == USER ? userAfloat : compAfloat) == 0;
+}
+
+// Counts the ships alive in the given Player p's fleet
+// returns the number of ships alive in said fleet
+template<class V>
+int BasicGame<V>::NumShipsAlive(Player p){
+  return __builtin_popcount(p == USER ? userAfloat : compAfloat);
+}
+
+
+// Sets the ship's coordinates to the first shipSize entries of coords and 
+// the matching mask of grid squares
+template<class V>
+void BasicShip<V>::setCoords(const pair<int, int> coords[]){
+  shipMask = Bitboard();
+  for(int i = 0; i < shipSize; i++){
+    shipCoords[i] = coords[i];
+    shipMask |= Bitboard::At(coords[i].first, coords[i].second);
+  }
+}
+
+
+// Sets the ship's squares to those of mask, with the coordinates listed in
+// order of their index on the grid
+template<class V>
+void BasicShip<V>::setMask(Bitboard mask){
+  shipMask = mask;
+  for(int n = 0; mask.Any(); n++){
+    int i = mask.LowestBit();
+    shipCoords[n] = make_pair(i / V::Height(), i % V::Height());
+    mask.ClearLowestBit();
+  }
+}
+
+
+// Reduces a ships health by 1
+// Sets the ships state to SUNK if health is reduced to 0
+template<class V>
+void BasicShip<V>::Damage(){
+  health--;
+  if(health == 0){
+    shipState = SUNK;
+  }
+}
+
+
+// Prompts the user for targeting coordinates and returns those coordinates as a 
+// pair of integers. Used pair to allow for ease of returning two variables.
+// Suspends until each line is given to input.
+template<class V>
+Task<pair<int, int> > BasicGame<V>::PromptFire(InputChannel &input){
+  pair<int, int> target;    // target coordinates to be returned
+  bool valid = false;       // bool to ensure valid entry
+  while(!valid){
+    PromptTarget();
+    string line = co_await input.Line();    // string input from the user
+    valid = TakeTarget(line, target);
+  }
+  co_return target;
+}
+
+
+// Asks the user where to fire
+template<class V>
+void BasicGame<V>::PromptTarget(){
+  display << "\nWhere would you like to fire (ex: C5)?";
+}
+
+
+// Handles one line of input given to PromptTarget. 
+// Returns true and sets target if the line holds coordinates that may be 
+// fired upon (or a forfeit); otherwise explains what was wrong with it.
+template<class V>
+bool BasicGame<V>::TakeTarget(const string &input, pair<int, int> &target){
+  SquareState tmpSS;        // temporary SquareState variable to be used for comparison
+  int inX,                  // integer conversion from the user's input
+      inY;                  // integer conversion from the user's input
+  bool valid = false,       // bool to ensure valid entry
+       isNum;               // boot to ensure that second half of input is a number
+  size_t maxLength = 1 + to_string(V::Width()).length();    // length of the longest coordinates
+  // Specification C3 - Secret Option
+  if(input == "~"){
+    display << "\n___________________"
+         << "\n| COMPUTER'S SHIPS \\"
+         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" 
+         << endl;
+    DisplayGrid(compShips, COMP);
+  }
+  // User selection to forfeit the game
+  else if(input == "ff" || input == "FF"){
+    //set to (99,99) to indicate escape sequence
+    target = make_pair(99, 99);
+    valid = true;
+  }
+  // User selection to force AI to forfeit
+  else if(input == "YOUSUNKMYBATTLESHIP"){
+    target = make_pair(999,999);
+    valid = true;
+  }
+  else{
+    //Bulletproof - checks to ensure input is of valid length, with at least one digit
+    if(input.length() > maxLength || input.length() < 2){
+      display << "\nInvalid entry. The correct format is format for entry is"
+           << " LetterNumber, with no decimals (ex: C5)." 
+           << endl;
+    }
+    else{
+      //Bulletproof - check to ensure that second half of input is a number
+      isNum = true;
+      for(int i = 1; i < input.length(); i++){
+        if(!isdigit(input[i])){
+          isNum = false;
+        }
+      }
+      // Specification B1 - Validate Input
+      if(!isalpha(input[0]) || !isNum){
+       display << "\nInvalid entry. The correct format is format for entry is"
+            << " LetterNumber, with no decimals (ex: C5)." 
+            << endl;
+      }
+      else{
+        // Bulletproof - handles both upper and lowercase letters
+        // Conversions from ASCII chars to integers
+        if(!isupper(input[0])){
+          inX = (int)input[0] - 97;
+        }
+        else{
+          inX = (int)input[0] - 65;
+        }
+        inY = stoi(input.substr(1,input.length() - 1)) - 1; 
+        if(inX >= V::Height() || inX < 0 || inY >= V::Width() || inY < 0){
+          display << "\nInvalid entry, those coordinates are off the grid!" 
+               << endl;
+        }
+        else{
+          // Specification A1 - Adv Input Validation
+          tmpSS = playerTargeting.getSquareState(inY, inX);
+          if(tmpSS != EMPTY){
+            // Check for Gametypes CRUISE_MISSILES or HARDCORE. SHOT_DOWN can still be fired upon.
+            if(tmpSS != SHOT_DOWN){
+            display << "\nInvalid entry, you have already fired on those coordinates!" 
+                 << endl;
+            }
+            else {
+            target = make_pair(inX, inY);
+            valid = true;
+            }
+          }
+          else {
+            target = make_pair(inX, inY);
+            valid = true;
+          }
+        }
+      }
+    }
+  }
+return valid;
+}
+
+
+// Checks to see if the given target coordinates result in a hit or miss. 
+// Changes the appropriate grids and ships to display the outcome of this check.
+template<class V>
+void BasicGame<V>::CheckHit(pair<int, int> target, Player p){
+  PROFILE_SCOPE(PHASE_HIT);
+  int tarRow = target.first;    
+  int tarCol = target.second;   // coordinates of the given target
+  LogFire(tarCol, tarRow, p);
+  if(tarRow == 99)
+  {
+    Forfeit(USER);
+  }
+  else if(tarRow == 999){
+    Forfeit(COMP);
+  }
+  else{
+    if(p == USER){
+      // a target is struck if it is a SHIP or SHOT_DOWN square
+      Bitboard struck = compShips.getMask(SHIP) | compShips.getMask(SHOT_DOWN);
+      if(struck.Test(Bitboard::Index(tarCol, tarRow))){
+        if(gameType == CRUISE_MISSILES || gameType == HARDCORE) {
+          if(ShootDownMissile()){
+            display << "Your missile was SHOT DOWN!" 
+                 << endl;
+            playerTargeting.setSquareState(tarCol, tarRow, SHOT_DOWN);
+            LogShotDown();
+          }
+          else {
+            ShipHit(tarCol, tarRow, p);
+          }
+        }
+        else{
+          ShipHit(tarCol, tarRow, p);
+        }
+      }
+      else{
+        // Conversion from ints to identifiable grid coordinates (Will be used a lot)
+        display << "\nYour shot at (" 
+             << char(tarRow + 65) << ", " 
+             << tarCol + 1 << ")"
+             << " was a MISS!" << endl;
+        playerTargeting.setSquareState(tarCol, tarRow, MISS);
+        LogMiss();
+      }
+    }
+    else{
+      display << "\nComputer fired at (" 
+           << char(tarRow + 65) << ", " 
+           << tarCol + 1 << ")."
+           << endl;
+      Bitboard struck = userShips.getMask(SHIP) | userShips.getMask(SHOT_DOWN);
+      if(struck.Test(Bitboard::Index(tarCol, tarRow))){
+        if(gameType == CRUISE_MISSILES || gameType == HARDCORE) {
+          if(ShootDownMissile()){
+            display << "The missile was SHOT DOWN!" 
+                 << endl;
+            compTargeting.setSquareState(tarCol, tarRow, SHOT_DOWN);
+            userShips.setSquareState(tarCol, tarRow, SHOT_DOWN);
+            LogShotDown();
+          }
+          else {
+           ShipHit(tarCol, tarRow, p);
+          }
+        }
+        else{
+          ShipHit(tarCol, tarRow, p);
+        }
+      }
+      else{
+        display << "It was a MISS!" << endl;
+        compTargeting.setSquareState(tarCol, tarRow, MISS);
+        userShips.setSquareState(tarCol, tarRow, MISS);
+        LogMiss();
+      }
+    }
+    RecordShot(tarCol, tarRow, p);
+    if(observer != nullptr){
+      observer->ShotFired(p, tarCol, tarRow, getTargeting(p).getSquareState(tarCol, tarRow), 
+                          GetShip(make_pair(tarCol, tarRow), p));
+    }
+  }
+}
+
+
+// Upon a ship being hit, prints to inform the user.
+// Also evaluates whether a ship was SUNK as a result from the hit.
+// Modifies respective grids to reflect these changes
+template<class V>
+void BasicGame<V>::ShipHit(int tarCol, int tarRow, Player p){
+  int shipLoc = GetShip(make_pair(tarCol, tarRow), p);    // index location of ship
+  LogHit();
+  if(p == USER){
+    display << "\nYour shot at (" 
+         << char(tarRow + 65) << ", " 
+         << tarCol + 1 << ")"
+         << " was a HIT!" << endl;
+    playerTargeting.setSquareState(tarCol, tarRow, HIT);
+    compFleet[shipLoc].Damage();
+    LogDamage(shipLoc, p);
+    if(compFleet[shipLoc].getShipState() == SUNK){
+      display << "\nYOU SUNK THE ENEMY'S " 
+           << compFleet[shipLoc].getName() << "!" 
+           << endl;
+      SinkShip(shipLoc, p);
+      LogSink(shipLoc, p);
+    }
+  }
+  else{
+    display << "It was a HIT!" << endl;
+    compTargeting.setSquareState(tarCol, tarRow, HIT);
+    userShips.setSquareState(tarCol, tarRow, HIT);
+    userFleet[shipLoc].Damage();
+    LogDamage(shipLoc, p);
+    if(userFleet[shipLoc].getShipState() == SUNK){
+      display << "\nTHE ENEMY SUNK YOUR " 
+           << userFleet[shipLoc].getName() << "!" 
+           << endl;
+    SinkShip(shipLoc, p);
+    LogSink(shipLoc, p);
+    } 
+  }
+}
+
+
+// Performs check to see if incoming missile was shot down (80% chance)
+template<class V>
+bool BasicGame<V>::ShootDownMissile(){
+  if(replayShot != nullptr){
+    return replayShot->result == SHOT_DOWN;
+  }
+  bool shotDown = false;
+  int rng = generator.Below(10) + 1;    // random number 1-10 generated to simulate chance
+  if(rng <= 8){
+    shotDown = true;
+  }
+  return shotDown;
+}
+
+
+
+// Checks the given coords to see which ship of the fleet Player p fires 
+// upon is contained at that location. 
+// Returns the index of where the ship is located in its repective fleet 
+// vector, or -1 if the square holds no ship.
+template<class V>
+int BasicGame<V>::GetShip(pair<int, int> coords, Player p) {
+  return shipIndex[p == USER ? COMP : USER][Bitboard::Index(coords.first, coords.second)];
+}
+
+
+//Displays the given grid
+/* EX:
+          1   2   3   4   5   6   7   8   9  10
+      -----------------------------------------
+    A |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    B |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    C |   |   |   |   |   |   | O |   |   |   |
+      -----------------------------------------
+    D |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    E |   |   |   |   | X |   |   |   |   |   |
+      -----------------------------------------
+    F |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    G |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    H |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    I |   |   |   |   |   |   |   |   |   |   |
+      -----------------------------------------
+    J |   |   |   |   |   |   | O |   |   |   |
+      -----------------------------------------
+*/
+// The status of the player's ships is shown beside the rows of the grid, two
+// rows per ship; ships that do not fit beside the grid are shown below it.
+template<class V>
+void BasicGame<V>::DisplayGrid(const Board &grid, Player p){
+  RenderGrid(grid, p);
+  screen.Write(display);
+}
+
+
+// Composes the given grid on the screen as DisplayGrid shows it
+template<class V>
+void BasicGame<V>::RenderGrid(const Board &grid, Player p){
+  PROFILE_SCOPE(PHASE_RENDER);
+  int shipsBeside = p == USER ? min(userFleet.getNumShips(), V::Height() / 2) : 0;   // ships shown
+                                                                                   // beside the grid
+  screen.Append("\n  ");
+  for (int col = 0; col < V::Width(); col++) {
+    if(col > 0){
+      screen.Append(' ');
+    }
+    screen.AppendNumber(col + 1, 3);
+  }
+  screen.Append('\n');
+  RenderMargin('-');
+  screen.Append('\n');
+  for (int row = 0; row < V::Height(); row++) {
+    screen.Append(char('A' + row));
+    screen.Append(" |");
+    for (int col = 0; col < V::Width(); col++) {
+      screen.Append(Square(grid.getSquareState(col, row)).getSymbol());
+      screen.Append('|');
+    }
+    // Displays the status of the user's ships after each grid line
+    if(row < 2 * shipsBeside){
+      if(row % 2 == 0){
+        PrintShipP1(row / 2, '-');
+      }
+      else{
+        PrintShipP2(row / 2, '-');
+      }
+    }
+    else{
+      screen.Append('\n');
+      RenderMargin('-');
+      screen.Append('\n');
+    }
+  }
+  if(p == USER){
+    // ships that did not fit are shown below the grid with a blank margin
+    for(int i = shipsBeside; i < userFleet.getNumShips(); i++){
+      RenderMargin(' ');
+      PrintShipP1(i, ' ');
+      RenderMargin(' ');
+      PrintShipP2(i, ' ');
+    }
+  }
+}
+
+
+// Composes the line drawn between rows of the grid when fill is '-', or
+// blanks as wide as that line when fill is ' '
+template<class V>
+void BasicGame<V>::RenderMargin(char fill){
+  screen.Append(2, fill == '-' ? ' ' : fill);
+  screen.Append(4 * V::Width() + 1, fill);
+}
+
+
+// PrintShip is divided into two parts. P1 prints the name of the ship as well as 
+// the top line of the squares that represent the ship and a line on the grid
+// (margin)
+// ex print:
+//
+// DESTROYER
+//  ---------
+// Both parts are composed on the screen.
+template<class V>
+void BasicGame<V>::PrintShipP1(int shipLoc, char margin){
+  string_view shipName = userFleet[shipLoc].getName();    // name of the ship to be printed
+  screen.Append("          ");
+  if(userFleet[shipLoc].getShipState() == SUNK){
+    screen.AppendStruck(shipName);
+  }
+  else{
+    screen.Append(shipName);
+  }
+  screen.Append('\n');
+  RenderMargin(margin);
+  screen.Append("            ");
+  for(int n = 0; n < userFleet[shipLoc].getSize(); n++){
+    screen.Append("----");
+  }
+  screen.Append("-\n");
+}
+
+
+// P2 of PrintShip prints the bottom parts of the squares and a line on the grid. 
+// The squares are filled X's, representing how damaged a ship is. 
+// Blank squares represent health points (ie. 5 blank squares = 5 health).
+// X's that have been struck are indicative of a SUNK ship
+// ex print:
+//
+//    | X |   |
+//    ---------
+template<class V>
+void BasicGame<V>::PrintShipP2(int shipLoc, char margin){
+  int shipSize = userFleet[shipLoc].getSize();        // size of the given ship
+  int shipHealth = userFleet[shipLoc].getHealth();    // health of the given ship
+  screen.Append("            ");
+  for(int i = 0; i < shipSize; i++){
+    screen.Append('|');
+    if(shipHealth == 0){
+      screen.Append(Square(SINK).getSymbol());
+    }
+    else if(i < shipSize - shipHealth){
+      screen.Append(" X ");
+    }
+    else{
+      screen.Append("   ");
+    }
+  }
+  screen.Append("|\n");
+  RenderMargin(margin);
+  screen.Append("            ");
+  for(int n = 0; n < shipSize; n++){
+    screen.Append("----");
+  }
+  screen.Append("-\n");
+}
+
+
+// Sets the SquareState of every grid square covered by the ship's mask
+// to SINK and removes the ship from its fleet's afloat mask.
+template<class V>
+void BasicGame<V>::SinkShip(int shipLoc, Player p){
+  if(p == USER){
+    playerTargeting.setSquares(compFleet[shipLoc].getMask(), SINK);
+    compAfloat &= ~(1 << shipLoc);
+  }
+  else{
+    Bitboard shipMask = userFleet[shipLoc].getMask();   // squares the ship occupies
+    compTargeting.setSquares(shipMask, SINK);
+    userShips.setSquares(shipMask, SINK);
+    userAfloat &= ~(1 << shipLoc);
+  }
+}
+
+
+// Checks to see if either player has won the game
+// Returns true if Player 'p' won; false if not.
+template<class V>
+bool BasicGame<V>::CheckWin(Player p){
+  bool win = false;   //bool to be returned
+  if(p == USER){
+    if(IsFleetDestroyed(COMP)){
+      gameState = USERWON;
+      LogWin(USER);
+      SaveRecord(USER);
+      display << "\nYOU HAVE DESTROYED ALL OF THE ENEMY'S SHIPS!"
+           << "\nYOU WIN!" << endl;
+      win = true;
+    }
+  }
+  else {
+    if(IsFleetDestroyed(USER)){
+      gameState = COMPWON;
+      LogWin(COMP);
+      SaveRecord(COMP);
+      display << "\nALL FRIENDLY SHIPS HAVE BEEN DESTROYED!"
+           << "\nTHE COMPUTER WINS!" << endl;
+      win = true;
+    }
+  }
+  return win;
+}
+
+
+//Sinks all Player 'p's ships in order to end the current game
+template<class V>
+void BasicGame<V>::Forfeit(Player p){
+  forfeiter = p;
+  if(p == USER) {
+    for(int i = 0; i < userFleet.getNumShips(); i++){
+      userFleet[i].setShipState(SUNK);
+    }
+    userAfloat = 0;
+  }
+  else {
+    for(int i = 0; i < compFleet.getNumShips(); i++){
+      compFleet[i].setShipState(SUNK);
+    }
+    compAfloat = 0;
+  }
+}
+
+
+// Menu displayed once a game has concluded.
+// Prompts the user if they would like to play again
+// Returns true if yes, false if no
+template<class V>
+bool BasicGame<V>::NewGameMenu(){
+  bool playAgain;             // bool to be returned
+  bool choiceMade = false;    // bool to ensure valid input
+  int input;                  // input from user
+
+  while(!choiceMade){
+    display << "\n___________________"
+         << "\n| PLAY AGAIN?      \\"
+         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+         << "\n1. Yes"
+         << "\n2. No"
+         << endl;
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      cin >> input;
+    }
     cin.clear();
     cin.ignore( 256, '\n' );
     switch(input) {
-      case 1: { 
-        RandomPlacement(USER);
+      case 1: 
+      { 
+        playAgain = true;
+        choiceMade = true;
+        break;
+      }
+      case 2: 
+      { 
+        playAgain = false;
         choiceMade = true;
+        display << "Goodbye!" << endl;
+        LogExit();
+        break;
+      }
+      //Bulletproof - Does not accept inputs other than 1 or 2
+      default: display << "\nInvalid entry, please enter either 1 or 2." 
+                    << endl;
         break;
+    }
+  }
+  return playAgain;
+}
+
+
+/*
+  SECTION 3:LOG
+
+  The following functions all deal with writing to the file, log.txt
+  Nothing is written when the game has no logger (non-interactive games).
+  Entries end with '\n' and are handed to the writer thread when the game
+  is won or exited.
+*/
+
+// Writes to log.txt whenever a new game is started.
+template<class V>
+void BasicGame<V>::LogStart(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << "BATTLESHIP \n--------------------------- \nNew game started on " 
+       << log->Date() << " at " << log->Time() << "." 
+       << "\nSeed " << getSeed() << " (replay with --seed " << getSeed() << ")\n";
+}
+
+// Writes to log.txt what Gametype was selected.
+template<class V>
+void BasicGame<V>::LogGameType(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << "Game Type ";
+  switch(gameType){
+    case CLASSIC: file << "CLASSIC";
+      break;
+    case MULTIFIRE: file << "MULTIFIRE";
+      break;
+    case CRUISE_MISSILES: file << "CRUISE MISSILES";
+      break;
+    case HARDCORE: file << "HARDCORE";
+      break;
+  }
+  file << " was selected.\n";
+}
+
+// Writes to log.txt whenever the program is exited.
+template<class V>
+void BasicGame<V>::LogExit(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << "Game exited on " << log->Date() << " at " << log->Time() << ".\n";
+  log->Close();
+  setLogger(nullptr);
+}
+
+//Writes to log.txt when and where a ship was placed on a grid
+template<class V>
+void BasicGame<V>::LogShipPlace(int shipLoc, Player p){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  const pair<int, int> *shipVec;      // coordinates of the ship
+  int shipSize;                       // size of given ship
+  file << "\n" << log->Time();
+  if(p == USER){
+    shipSize = userFleet[shipLoc].getSize();
+    shipVec = userFleet[shipLoc].getCoords();
+    file << " Player's " << userFleet[shipLoc].getName();
+  }
+  else{
+    shipSize = compFleet[shipLoc].getSize();
+    shipVec = compFleet[shipLoc].getCoords();
+    file << " Computer's " << compFleet[shipLoc].getName();
+  }
+  file << " placed at the following coordinates: \n";
+  for(int i = 0; i < shipSize; i++){
+    file << "(" << char(shipVec[i].second + 65) << ", " 
+         << shipVec[i].first + 1 << ")\n"; 
+  }
+}
+
+// Writes to log.txt whenever the player or computer fires. 
+// Also writes the point(x,y) fired upon
+template<class V>
+void BasicGame<V>::LogFire(int tarCol, int tarRow, Player p){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << "\n" << log->Time(); 
+  if(p == USER){
+    file << " Player";
+  }
+  else{
+    file << " Computer";
+  }
+  file << " fired at (" 
+       << char(tarRow + 65) << ", " 
+       << tarCol + 1 << ").";
+}
+
+//Writes to log.txt when a shot is determined to be a hit
+template<class V>
+void BasicGame<V>::LogHit(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << " It was a HIT.\n";
+}
+
+//Writes to log.txt when a shot is determined to be a miss
+template<class V>
+void BasicGame<V>::LogMiss(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << " It was a MISS.\n";
+}
+
+template<class V>
+void BasicGame<V>::LogShotDown(){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  file << " The missile was SHOT DOWN.\n";
+}
+
+//Writes to log.txt when a ship is damaged
+template<class V>
+void BasicGame<V>::LogDamage(int shipLoc, Player p){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  if(p == USER){
+    file << "The computer's " << compFleet[shipLoc].getName()       << " was damaged." 
+         << " Health reduced to " 
+         << compFleet[shipLoc].getHealth() 
+         << "/" 
+         << compFleet[shipLoc].getSize() 
+         << ".\n";
+  }
+  else{
+    file << "The player's " << userFleet[shipLoc].getName() << " was damaged." 
+    << " Health reduced to " 
+    << userFleet[shipLoc].getHealth() 
+    << "/" 
+    << userFleet[shipLoc].getSize() 
+    << ".\n";
+  }
+}
+
+//Writes to log.txt when a ship is sunk
+template<class V>
+void BasicGame<V>::LogSink(int shipLoc, Player p){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  if(p == USER){
+    file << "The computer's " << compFleet[shipLoc].getName() << " was sunk.\n";
+  }
+  else{
+    file << "The player's " << userFleet[shipLoc].getName() << " was sunk.\n";
+  }
+}
+
+//Writes to log.txt whenever the user or computer wins.
+//The game is over, so the log is flushed to the file.
+template<class V>
+void BasicGame<V>::LogWin(Player p){
+  PROFILE_SCOPE(PHASE_LOG);
+  if(log == nullptr){
+    return;
+  }
+  if(p == USER){
+    file << "\n" << log->Time() << " The Player WON!\n";
+  }
+  else{
+    file << "\n" << log->Time() << " The Computer WON!\n";
+  }
+  log->Flush();
+}
+
+
+// Adds the shot just fired at (tarCol,tarRow) by Player p to the game's 
+// record. The result is read from the targeting grid, which holds MISS, HIT, 
+// SINK or SHOT_DOWN at the target once the shot has been resolved.
+template<class V>
+void BasicGame<V>::RecordShot(int tarCol, int tarRow, Player p){
+  if(recorder == nullptr){
+    return;
+  }
+  static const int resultCodes[6] = {0, 1, -1, -1, 2, 3};   // code of each SquareState
+  const Board &targeting = p == USER ? playerTargeting : compTargeting;
+  int square = Bitboard::Index(tarCol, tarRow);
+  recordedShots.push_back((square << 3) | (p << 2) | resultCodes[targeting.getSquareState(tarCol, tarRow)]);
+}
+
+
+// Appends the finished game to the record file in the format described at
+// GameRecordWriter.
+template<class V>
+void BasicGame<V>::SaveRecord(Player winner){
+  if(recorder == nullptr){
+    return;
+  }
+  vector<uint8_t> body;     // record without its leading length
+  PutVarint(body, getSeed());
+  uint8_t forfeit = forfeiter < 0 ? 0 : 8 | forfeiter << 4;   // forfeit flag and forfeiter bits
+  body.push_back(uint8_t(gameType | (winner << 2) | forfeit));
+  for(const Fleet *fleet : {&userFleet, &compFleet}){
+    for(const Ship &ship : *fleet){
+      Bitboard mask = ship.getMask();
+      int origin = mask.LowestBit();
+      PutVarint(body, origin * 2 + mask.Test(origin + 1));
+    }
+  }
+  PutVarint(body, recordedShots.size());
+  int shotBits = recorder->getFormat().ShotBits();
+  uint64_t pending = 0;     // packed bits not yet added to body
+  int numPending = 0;       // number of bits in pending
+  for(uint16_t shot : recordedShots){
+    pending |= uint64_t(shot) << numPending;
+    numPending += shotBits;
+    while(numPending >= 8){
+      body.push_back(uint8_t(pending));
+      pending >>= 8;
+      numPending -= 8;
+    }
+  }
+  if(numPending > 0){
+    body.push_back(uint8_t(pending));
+  }
+  vector<uint8_t> record;   // the record as appended to the file
+  record.reserve(body.size() + 2);
+  PutVarint(record, body.size());
+  record.insert(record.end(), body.begin(), body.end());
+  recorder->Append(record);
+  recordedShots.clear();
+}
+
+
+/*
+  SECTION 4: REPLAY
+
+  The following functions re-execute a game stored in a game record file.
+*/
+
+// Replays a recorded game with no user input. The fleets are placed where 
+// the record says, then the recorded shots are fired through CheckHit turn by
+// turn, with each turn taken by the player it belongs to and made of as many
+// shots as the Gametype allows. Whether a missile is shot down is taken from 
+// the record, as the game's random draws also depended on how the fleets 
+// were placed. The game is checked against the record after every shot and
+// every turn.
+// Returns true if the game played out as recorded; otherwise divergence is
+// set to a description of the first difference. A record may only end before
+// either fleet is destroyed if it says the game was forfeited by the player 
+// who did not win.
+template<class V>
+bool BasicGame<V>::Replay(const RecordedGame &record, string &divergence){
+  int origin[2 * V::maxShips];        // recorded placement of every ship
+  bool vertical[2 * V::maxShips];
+  ConstructFleets();
+  record.Placements(origin, vertical);
+  for(int i = 0; i < 2 * V::NumShips(); i++){
+    Player p = i < V::NumShips() ? USER : COMP;
+    if(!PlaceRecordedShip(i % V::NumShips(), p, origin[i], vertical[i])){
+      divergence = string(p == USER ? "the player's " : "the computer's ") + V::ShipName(i % V::NumShips())
+                 + " does not fit where it was recorded";
+      return false;
+    }
+  }
+  gameState = PLAYING;
+  int next = 0;     // index of the next recorded shot
+  for(Player p = USER; ; p = (p == USER) ? COMP : USER){
+    int numShots = (gameType == MULTIFIRE || gameType == HARDCORE) ? NumShipsAlive(p) : 1;
+    for(int i = 0; i < numShots; i++){
+      if(next == record.numShots){
+        if(!record.forfeited || record.winner == record.forfeiter){
+          divergence = "the record ends after shot " + to_string(next) + " with both fleets afloat, "
+                     + (!record.forfeited ? "but the game was not forfeited" 
+                                          : "and names the player who forfeited as the winner");
+          return false;
+        }
+        return true;
+      }
+      RecordedShot shot = record.Shot(next);
+      if(shot.player != p || shot.square >= V::Squares()){
+        divergence = "shot " + to_string(next + 1) + " is not a legal shot by the " 
+                   + (p == USER ? "player" : "computer");
+        return false;
+      }
+      int tarCol = shot.square / V::Height(), tarRow = shot.square % V::Height();
+      replayShot = &shot;
+      CheckHit(make_pair(tarRow, tarCol), p);
+      replayShot = nullptr;
+      SquareState result = (p == USER ? playerTargeting : compTargeting).getSquareState(tarCol, tarRow);
+      if(result != shot.result){
+        divergence = "shot " + to_string(next + 1) + " by the " + (p == USER ? "player" : "computer")
+                   + " at (" + char('A' + tarRow) + ", " + to_string(tarCol + 1) + ") was a "
+                   + ResultName(result) + ", the record says " + ResultName(shot.result);
+        return false;
+      }
+      next++;
+    }
+    if(CheckWin(p)){
+      if(p != record.winner){
+        divergence = string("the ") + (p == USER ? "player" : "computer") + " won, the record says the " 
+                   + (record.winner == USER ? "player" : "computer");
+        return false;
+      }
+      if(next != record.numShots){
+        divergence = to_string(record.numShots - next) + " shots were recorded after the game was won";
+        return false;
+      }
+      if(record.forfeited){
+        divergence = "the game was won by sinking a fleet, the record says it was forfeited";
+        return false;
+      }
+      return true;
+    }
+  }
+}
+
+
+// Places ship shipLoc of Player p's fleet with its first square at Bitboard
+// index origin, running down the grid if vertical and across it otherwise.
+// Returns false if the ship leaves the grid or overlaps another ship.
+template<class V>
+bool BasicGame<V>::PlaceRecordedShip(int shipLoc, Player p, int origin, bool vertical){
+  Board &ships = (p == USER) ? userShips : compShips;
+  Ship &ship = (p == USER) ? userFleet[shipLoc] : compFleet[shipLoc];
+  int x = origin / V::Height(), y = origin % V::Height();
+  if(origin < 0 || origin >= V::Squares() || (vertical ? y : x) + ship.getSize() > (vertical ? V::Height() : V::Width())){
+    return false;
+  }
+  Bitboard shipMask = vertical ? Bitboard::Vertical(x, y, ship.getSize()) 
+                               : Bitboard::Horizontal(x, y, ship.getSize());
+  if((shipMask & ~ships.getMask(EMPTY)).Any()){
+    return false;
+  }
+  ship.setMask(shipMask);
+  PlaceShip(shipLoc, p);
+  return true;
+}
+
+
+/*
+  Below exists all functions used for the coroutines a game is played with
+*/
+
+
+thread_local FrameAllocator::FreeLists FrameAllocator::freeLists;
+
+
+// Returns a frame of at least size bytes, reusing a freed one of the same 
+// size class when there is one
+void *FrameAllocator::Allocate(size_t size){
+  size_t units = (size + unit - 1) / unit;      // size class of the frame
+  long total = bytesInUse.fetch_add(units * unit, memory_order_relaxed) + units * unit;
+  long peak = peakBytes.load(memory_order_relaxed);
+  while(total > peak && !peakBytes.compare_exchange_weak(peak, total, memory_order_relaxed)){
+  }
+  if(units < numClasses && freeLists.heads[units]){
+    FreeFrame *frame = freeLists.heads[units];
+    freeLists.heads[units] = frame->next;
+    return frame;
+  }
+  return ::operator new(units * unit);
+}
+
+
+// Keeps a frame given by Allocate(size) for reuse
+void FrameAllocator::Free(void *p, size_t size){
+  size_t units = (size + unit - 1) / unit;      // size class of the frame
+  bytesInUse.fetch_sub(units * unit, memory_order_relaxed);
+  if(units < numClasses){
+    FreeFrame *frame = static_cast<FreeFrame *>(p);
+    frame->next = freeLists.heads[units];
+    freeLists.heads[units] = frame;
+  }
+  else{
+    ::operator delete(p);
+  }
+}
+
+
+FrameAllocator::FreeLists::~FreeLists(){
+  for(FreeFrame *&head : heads){
+    while(head){
+      ::operator delete(exchange(head, head->next));
+    }
+  }
+}
+
+
+// Plays task at the terminal, giving it each line typed until it is done.
+// Returns false if cin ran out before that.
+bool RunAtTerminal(Task<> task, InputChannel &input){
+  PROFILE_SCOPE(PHASE_GAME);
+  string line;    // line typed by the user
+  task.Start();
+  while(!task.Done()){
+    {
+      PROFILE_SCOPE(PHASE_INPUT);
+      if(!getline(cin, line)){
+        return false;
+      }
+    }
+    input.Push(line);
+  }
+  return true;
+}
+
+
+/*
+  Below exists all functions used for the GamePool class
+*/
+
+template<class V>
+BasicGamePool<V>::BasicGamePool(int numGames){
+  for(int i = 0; i < numGames; i++){
+    idle.push_back(unique_ptr<BasicGame<V> >(new BasicGame<V>(CLASSIC, false, 0)));
+  }
+}
+
+
+// Checks out an idle game, Reset to the Gametype gt and the given seed
+// A new game is constructed if none are idle.
+template<class V>
+unique_ptr<BasicGame<V> > BasicGamePool<V>::Acquire(Gametype gt, uint64_t seed){
+  unique_ptr<BasicGame<V> > game;   // game to be handed out
+  {
+    lock_guard<mutex> guard(lock);
+    if(!idle.empty()){
+      game = move(idle.back());
+      idle.pop_back();
+    }
+  }
+  if(!game){
+    return unique_ptr<BasicGame<V> >(new BasicGame<V>(gt, false, seed));
+  }
+  game->Reset(gt, seed);
+  return game;
+}
+
+
+// Returns a game to the pool once its player is done with it
+template<class V>
+void BasicGamePool<V>::Release(unique_ptr<BasicGame<V> > game){
+  game->Detach();
+  lock_guard<mutex> guard(lock);
+  idle.push_back(move(game));
+}
+
+
+/*
+  Below exists all functions used for the TranspositionTable
+*/
+
+// Draws every key with splitmix64 from a fixed seed
+template<class V>
+ZobristKeys<V>::ZobristKeys(){
+  uint64_t state = 0x9E3779B97F4A7C15ULL;   // splitmix64 state
+  auto next = [&state](){
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  };
+  for(int i = 0; i < V::maxSquares; i++){
+    for(int st = MISS; st <= SHOT_DOWN; st++){
+      square[i][st] = st == EMPTY ? 0 : next();
+    }
+  }
+  for(int s = 0; s <= V::maxShipSize; s++){
+    smallest[s] = next();
+  }
+}
+
+
+// Hashes a grid from scratch
+template<class V>
+uint64_t ZobristKeys<V>::Hash(const BasicBoard<V> &grid) const{
+  uint64_t hash = 0;
+  for(SquareState st : {MISS, HIT, SINK, SHOT_DOWN}){
+    for(BasicBitboard<V> mask = grid.getMask(st); mask.Any(); mask.ClearLowestBit()){
+      hash ^= square[mask.LowestBit()][st];
+    }
+  }
+  return hash;
+}
+
+
+template<class V>
+TranspositionTable<V>::TranspositionTable(size_t bytes){
+  numEntries = 0;
+  if(bytes >= sizeof(Entry)){
+    numEntries = size_t(1) << (63 - __builtin_clzll(bytes / sizeof(Entry)));
+    entries.reset(new Entry[numEntries]);
+  }
+}
+
+
+// Looks up a decision. Returns true and sets target, and heatmap[0] to 
+// heatmap[V::Squares() - 1] if heatmap is given, if the decision was found.
+template<class V>
+bool TranspositionTable<V>::Probe(uint64_t key, int &target, int16_t heatmap[]) const{
+  const Entry &entry = entries[key & (numEntries - 1)];
+  uint32_t sequence = entry.sequence.load(memory_order_acquire);   // sequence before the copy
+  if((sequence & 1) || entry.key.load(memory_order_relaxed) != key){
+    return false;
+  }
+  int copied = entry.target.load(memory_order_relaxed);   // target as copied
+  if(heatmap){
+    uint64_t words[heatWords];    // heatmap as copied
+    for(int w = 0; w < (V::Squares() + 3) / 4; w++){
+      words[w] = entry.heatmap[w].load(memory_order_relaxed);
+    }
+    memcpy(heatmap, words, V::Squares() * sizeof(int16_t));
+  }
+  atomic_thread_fence(memory_order_acquire);
+  if(entry.sequence.load(memory_order_relaxed) != sequence){
+    return false;
+  }
+  target = copied;
+  return true;
+}
+
+
+// Stores a decision with the heatmap it was made from, which must have room
+// for a multiple of 4 squares. Does nothing if another thread is writing the
+// same entry.
+template<class V>
+void TranspositionTable<V>::Store(uint64_t key, int target, const int16_t heatmap[]){
+  Entry &entry = entries[key & (numEntries - 1)];
+  uint32_t sequence = entry.sequence.load(memory_order_relaxed);  // even while nobody writes
+  if((sequence & 1) || !entry.sequence.compare_exchange_strong(sequence, sequence + 1, memory_order_acquire)){
+    return;
+  }
+  atomic_thread_fence(memory_order_release);
+  entry.key.store(key, memory_order_relaxed);
+  entry.target.store(target, memory_order_relaxed);
+  for(int w = 0; w < (V::Squares() + 3) / 4; w++){
+    uint64_t word;
+    memcpy(&word, heatmap + 4 * w, sizeof(word));
+    entry.heatmap[w].store(word, memory_order_relaxed);
+  }
+  entry.sequence.store(sequence + 2, memory_order_release);
+}
+
+
+// Empties every entry. No other thread may use the table meanwhile.
+template<class V>
+void TranspositionTable<V>::Clear(){
+  for(size_t i = 0; i < numEntries; i++){
+    entries[i].key.store(0, memory_order_relaxed);
+  }
+}
+
+
+// Returns the table every AIOpponent of variant V shares, of 
+// transpositionBytes bytes, or nullptr if the table is off
+template<class V>
+TranspositionTable<V> *TranspositionTable<V>::Shared(){
+  static TranspositionTable table(transpositionBytes);
+  return table.Size() > 0 ? &table : nullptr;
+}
+
+
+/*
+  Below exists all functions used for the OpeningBook
+*/
+
+// Maps the opening book at path into memory and checks its header. Nothing
+// else is read until a decision is looked up.
+// Returns false if the file cannot be mapped or is not an opening book for 
+// the grid and fleet of variant V.
+template<class V>
+bool OpeningBook<V>::Open(const string &path){
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0){
+    return false;
+  }
+  struct stat info;
+  if(fstat(fd, &info) == 0 && info.st_size > 16){
+    void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map != MAP_FAILED){
+      data = static_cast<const uint8_t *>(map);
+      size = info.st_size;
+      madvise(map, size, MADV_RANDOM);
+    }
+  }
+  close(fd);
+  RecordFormat format;                  // grid and fleet the book was built for
+  size_t formatBytes = data ? DecodeFormat(data + 16, size - 16, format) : 0;   // length of its header
+  size_t keysAt = 16 + (formatBytes + 7) / 8 * 8;     // offset of the first key
+  uint64_t n = 0;                       // decisions the header claims
+  if(data){
+    memcpy(&n, data + 8, sizeof(n));
+  }
+  if(formatBytes == 0 || memcmp(data, "BSOB", 4) != 0 || data[4] != 1 || !(format == VariantFormat<V>())
+     || keysAt > size || (size - keysAt) % 10 != 0 || n != (size - keysAt) / 10){
+    Close();
+    return false;
+  }
+  keys = reinterpret_cast<const uint64_t *>(data + keysAt);
+  targets = reinterpret_cast<const uint16_t *>(data + keysAt + n * sizeof(uint64_t));
+  numEntries = n;
+  maxFired = data[5];
+  return true;
+}
+
+
+// Unmaps the file
+template<class V>
+void OpeningBook<V>::Close(){
+  if(data){
+    munmap(const_cast<uint8_t *>(data), size);
+  }
+  data = nullptr;
+  keys = nullptr;
+  targets = nullptr;
+  size = numEntries = 0;
+  maxFired = 0;
+}
+
+
+// Finds a decision by binary search of the sorted hashes, which touches a 
+// handful of pages of the file. Returns true and sets target if the book 
+// holds the decision.
+template<class V>
+bool OpeningBook<V>::Lookup(uint64_t key, int &target) const{
+  const uint64_t *found = lower_bound(keys, keys + numEntries, key);   // first hash not below key
+  if(found == keys + numEntries || *found != key){
+    return false;
+  }
+  target = targets[found - keys];
+  return true;
+}
+
+
+// Returns the book every AIOpponent of variant V consults, opened from 
+// openingBookPath the first time it is asked for, or nullptr if there is no
+// book or it could not be opened
+template<class V>
+const OpeningBook<V> *OpeningBook<V>::Shared(){
+  static OpeningBook book;
+  static bool opened = !openingBookPath.empty() && book.Open(openingBookPath);
+  return opened ? &book : nullptr;
+}
+
+
+// Plays numGames openings, opening number i seeded with seed + i, in which 
+// the heuristic AI fires at a randomly placed fleet until it has fired at 
+// maxFired squares. Every hunt-phase decision (one made with no HIT on the 
+// grid) taken in at least two openings is written to an opening book at 
+// path; grids reached only once are unlikely to come up again.
+// Returns 1 if the book could not be written.
+template<class V>
+int BuildOpeningBook(const string &path, long numGames, int maxFired, uint64_t seed){
+  const ZobristKeys<V> &keys = TranspositionTable<V>::keys;
+  BasicGamePool<V> pool(1);
+  unique_ptr<BasicGame<V> > game = pool.Acquire(CLASSIC, seed);   // game the openings are played on
+  BasicAIOpponent<V> ai;                          // AI whose decisions are recorded
+  vector<pair<uint64_t, uint16_t> > decisions;    // hash and square of every hunt-phase decision
+  vector<uint64_t> bookKeys;                      // hash of every decision in the book
+  vector<uint16_t> bookTargets;                   // square chosen for each of bookKeys
+  size_t distinct = 0;                            // different decisions recorded
+  ai.setCache(nullptr);
+  ai.setBook(nullptr);
+  for(long i = 0; i < numGames; i++){
+    game->Reset(CLASSIC, seed + i);
+    game->ConstructFleets();
+    game->RandomPlacement(USER);
+    for(int fired = 0; fired < maxFired && !game->IsFleetDestroyed(USER); fired++){
+      const BasicBoard<V> &grid = game->getTargeting(COMP);
+      int s = ai.SmallestShipAlive(game->getFleet(USER));   // smallest ship AFLOAT
+      pair<int, int> target = ai.EvaluateGrid(grid, s);
+      if(!grid.getMask(HIT).Any()){
+        decisions.push_back(make_pair(keys.Hash(grid) ^ keys.smallest[s], 
+                                      target.second * V::Height() + target.first));
+      }
+      game->CheckHit(target, COMP);
+    }
+  }
+  pool.Release(move(game));
+
+  // A grid comes up at most once per opening, so a run of n equal hashes was
+  // reached by n openings
+  sort(decisions.begin(), decisions.end());
+  for(size_t i = 0, j; i < decisions.size(); i = j){
+    for(j = i + 1; j < decisions.size() && decisions[j].first == decisions[i].first; j++){}
+    distinct++;
+    if(j - i >= 2){
+      bookKeys.push_back(decisions[i].first);
+      bookTargets.push_back(decisions[i].second);
+    }
+  }
+  uint64_t n = bookKeys.size();             // decisions in the book
+  vector<uint8_t> header = {'B', 'S', 'O', 'B', 1, uint8_t(maxFired), 0, 0};
+  vector<uint8_t> format = EncodeFormat(VariantFormat<V>());
+  header.insert(header.end(), reinterpret_cast<uint8_t *>(&n), reinterpret_cast<uint8_t *>(&n + 1));
+  header.insert(header.end(), format.begin(), format.end());
+  header.resize((header.size() + 7) / 8 * 8, 0);
+  ofstream out(path, ios::binary | ios::trunc);
+  out.write(reinterpret_cast<const char *>(header.data()), header.size());
+  out.write(reinterpret_cast<const char *>(bookKeys.data()), n * sizeof(uint64_t));
+  out.write(reinterpret_cast<const char *>(bookTargets.data()), n * sizeof(uint16_t));
+  out.close();
+  if(!out){
+    cerr << "Could not write " << path << endl;
+    return 1;
+  }
+  cout << "Opening book: " << n << " of " << distinct << " hunt-phase grids from " << numGames 
+       << " openings of " << maxFired << " shots, " << header.size() + n * 10 << " bytes written to "
+       << path << endl;
+  return 0;
+}
+
+
+/*
+  Below exists all functions used for the AIOpponent class
+*/
+
+// Main AI function: finds the square of the targeting grid most likely to 
+// contain a ship, using integers representing the probability that a ship is 
+// contained at each location.
+// Assumes standard distribution of ships, with each coordinate as likely to 
+// contain a ship as the next when looking at an empty board.
+// The placement weights come from the density map, which is brought up to 
+// date with only the squares that changed since the last evaluation. A large
+// number of changes (such as a new game) rebuilds the map instead.
+// The squares are scored and the most weighted one found by the GridKernels;
+// ties go to the lowest square, as they did when the grid was scanned in order.
+// In the opening, a decision in the OpeningBook or already in the 
+// TranspositionTable is returned straight away; the density map catches up
+// with the grid on the next decision not found there.
+template<class V>
+pair<int, int> BasicAIOpponent<V>::EvaluateGrid(const Board &grid, int s ){
+  PROFILE_SCOPE(PHASE_AI);
+  const GridKernels &kernels = GridKernels::Active();
+  const ZobristKeys<V> &keys = TranspositionTable<V>::keys;
+  int16_t tmp[numLanes];          // weight of every square
+  Bitboard changed;               // squares whose state differs from the known grid
+  for(int st = MISS; st <= SHOT_DOWN; st++){
+    changed |= grid.getMask(SquareState(st)) ^ known.getMask(SquareState(st));
+  }
+  uint64_t gridHash = knownHash;  // Zobrist hash of grid
+  for(Bitboard rest = changed; rest.Any(); rest.ClearLowestBit()){
+    int i = rest.LowestBit();
+    int x = i / V::Height(), y = i % V::Height();
+    gridHash ^= keys.square[i][known.getSquareState(x, y)] ^ keys.square[i][grid.getSquareState(x, y)];
+  }
+  uint64_t key = gridHash ^ keys.smallest[s];   // hash of this decision
+  int high;                       // most weighted square
+  Bitboard fired = grid.getMask(HIT) | grid.getMask(MISS) | grid.getMask(SINK);   // squares fired at
+  int numFired = fired.Count();   // number of squares fired at
+  bool opening = numFired <= cacheShots;
+  // A square already fired at can only come from a hash collision
+  if(book && numFired <= book->getMaxFired() && !grid.getMask(HIT).Any()){
+    bookProbes++;
+    if(book->Lookup(key, high) && high < V::Squares() && !fired.Test(high)){
+      bookHits++;
+      return make_pair(high % V::Height(), high / V::Height());
+    }
+  }
+  if(cache && opening){
+    cacheProbes++;
+    if(cache->Probe(key, high, nullptr) && !fired.Test(high)){
+      cacheHits++;
+      return make_pair(high % V::Height(), high / V::Height());
+    }
+  }
+  SetMinSize(s);
+  if(changed.Count() > kernels.rebuildLimit){
+    RebuildDensity(grid);
+  }
+  else{
+    while(changed.Any()){
+      int i = changed.LowestBit();
+      Board before = known;   // grid before this square changed
+      int x = i / V::Height(), y = i % V::Height();
+      known.setSquareState(x, y, grid.getSquareState(x, y));
+      UpdateSquare(before, known, i);
+      changed.ClearLowestBit();
+    }
+  }
+  knownHash = gridHash;
+  high = ScoreGrid(grid, weight, tmp);
+  //DisplayProbabilityGrid(tmp);  //uncomment for debugging
+  if(cache && opening){
+    cache->Store(key, high, tmp);
+  }
+  return make_pair(high % V::Height(), high / V::Height());
+}
+
+
+// Evaluates every grid of the batch as EvaluateGrid would with its smallest 
+// ship AFLOAT (taken as 2 or V::maxShipSize if it lies outside those sizes),
+// writing the chosen target of grid b to targets[b] and, if heatmaps is 
+// given, the weight of every square (0 where it may not be shot) to 
+// heatmaps[b * V::Squares()] onward in Bitboard order.
+// Grids of a batch are unrelated to each other, so each is evaluated from 
+// scratch without touching the density map kept for EvaluateGrid. Only the 
+// sizes from the smallest ship AFLOAT up are accumulated, straight into one 
+// weight map. The lanes of that map and of the kernels' scratch space are 
+// reused for every grid, so they stay in the L1 cache while the batch streams
+// past. Grids whose decision is in the TranspositionTable, heatmap and all,
+// are not evaluated.
+template<class V>
+void BasicAIOpponent<V>::EvaluateBatch(const BasicBoardBatch<V> &batch, pair<int, int> targets[], 
+                                       int16_t heatmaps[]){
+  PROFILE_SCOPE(PHASE_AI);
+  const ZobristKeys<V> &keys = TranspositionTable<V>::keys;
+  int lanes = Lanes();              // lanes covering every square
+  int16_t batchWeight[numLanes];    // weight of the grid being evaluated
+  int16_t tmp[numLanes];            // weight of every square
+  for(int b = 0; b < batch.Size(); b++){
+    Board grid = batch.getBoard(b);   // grid being evaluated
+    int s = clamp(batch.smallest[b], 2, V::maxShipSize);    // smallest ship AFLOAT
+    int16_t *heatmap = heatmaps ? heatmaps + (long)b * V::Squares() : nullptr;   // heatmap of grid b
+    uint64_t key = 0;                 // hash of this decision
+    int high;                         // most weighted square
+    if(cache){
+      key = keys.Hash(grid) ^ keys.smallest[s];
+      cacheProbes++;
+      if(cache->Probe(key, high, heatmap) && !grid.getMask(HIT).Test(high) && !grid.getMask(MISS).Test(high)
+         && !grid.getMask(SINK).Test(high)){
+        cacheHits++;
+        targets[b] = make_pair(high % V::Height(), high / V::Height());
+        continue;
+      }
+    }
+    ExpandGrid(grid);
+    fill(batchWeight, batchWeight + lanes, 0);
+    for(int k = s; k <= V::maxShipSize; k++){
+      AccumulateSize(k, batchWeight);
+    }
+    high = ScoreGrid(grid, batchWeight, tmp);
+    targets[b] = make_pair(high % V::Height(), high / V::Height());
+    if(heatmap){
+      copy(tmp, tmp + V::Squares(), heatmap);
+    }
+    if(cache){
+      cache->Store(key, high, tmp);
+    }
+  }
+}
+
+
+// Scores every square of the grid from the given placement weights and 
+// returns the most weighted square, leaving the score of each square in 
+// score[].
+template<class V>
+int BasicAIOpponent<V>::ScoreGrid(const Board &grid, const int16_t weights[], int16_t score[]){
+  const GridKernels &kernels = GridKernels::Active();
+  int lanes = Lanes();            // lanes covering every square
+  int16_t firedLanes[numLanes], shotDownLanes[numLanes];    // fired and shotDown as lanes
+  fill(score, score + lanes, 0);
+  // If a square is a HIT, special weighting is applied to the immediate surrounding coordinates.
+  Bitboard hits = grid.getMask(HIT);
+  while(hits.Any()){
+    int i = hits.LowestBit();
+    AddHitWeight(grid, i / V::Height(), i % V::Height(), score);
+    hits.ClearLowestBit();
+  }
+  // A square with a state of SHOT_DOWN is given immense weight to ensure that the square is retargeted.
+  // Squares of HIT, MISS, or SINK are never shot at, even though they may have received weight above.
+  Bitboard shotDown = grid.getMask(SHOT_DOWN);
+  // Specification C2 - Prohibit AI wasted shots
+  Bitboard fired = grid.getMask(HIT) | grid.getMask(MISS) | grid.getMask(SINK);
+  kernels.ExpandBits(fired.words, lanes, firedLanes);
+  kernels.ExpandBits(shotDown.words, lanes, shotDownLanes);
+  return kernels.ScoreTarget(score, weights, firedLanes, shotDownLanes, lanes);
+}
+
+
+// Returns true if placement p of the DensityPlacementTable is counted on the 
+// given grid: its starting square must be EMPTY and the ship must fit 
+// according to the Eval function of its direction.
+// ex: Assuming an empty board - at x = 0, y = 0, only the down and right
+//     placements fit. 
+template<class V>
+bool BasicAIOpponent<V>::PlacementFits(const Board &grid, int p){
+  Bitboard blocked = grid.getMask(MISS) | grid.getMask(SINK);
+  return grid.getMask(EMPTY).Test(Tables::density.origin[p]) 
+      && !(Tables::density.interior[p] & blocked).Any();
+}
+
+
+// Adds n to the density of every square counted by placement p of the 
+// DensityPlacementTable. A placement counts its starting square and the 
+// squares up to i - 1 spaces away.
+template<class V>
+void BasicAIOpponent<V>::AddPlacement(int p, int n){
+  int i = Tables::density.size[p];
+  Bitboard counted = Tables::density.counted[p];
+  while(counted.Any()){
+    int square = counted.LowestBit();
+    density[i - 2][square] += n;
+    if(i >= minSize){
+      weight[square] += n;
+    }
+    counted.ClearLowestBit();
+  }
+}
+
+
+// Updates the density map after square i changed from its state in before to
+// its state in after. Only the placements counted at square i depend on it,
+// so at most 40 placements are checked with the standard fleet.
+template<class V>
+void BasicAIOpponent<V>::UpdateSquare(const Board &before, const Board &after, int i){
+  for(int c = Tables::density.coverFirst[i]; c < Tables::density.coverFirst[i + 1]; c++){
+    int p = Tables::density.cover[c];
+    int change = int(PlacementFits(after, p)) - int(PlacementFits(before, p));
+    if(change != 0){
+      AddPlacement(p, change);
+    }
+  }
+}
+
+
+// Rebuilds the density map for the given grid from scratch.
+// Looks at every ship size from 2 to V::maxShipSize in the four possible 
+// directions from each point. Density values are then incremented by 1 for 
+// each time a ship is able to fit in the spots of the given directions, a 
+// whole direction of one size at a time by GridKernels::AccumulateDirection.
+template<class V>
+void BasicAIOpponent<V>::RebuildDensity(const Board &grid){
+  int lanes = Lanes();    // lanes covering every square
+  ExpandGrid(grid);
+  for(int k = 2; k <= V::maxShipSize; k++){
+    fill(density[k - 2], density[k - 2] + lanes, 0);
+    AccumulateSize(k, density[k - 2]);
+  }
+  for(int i = 0; i < lanes; i++){
+    weight[i] = 0;
+    for(int k = minSize; k <= V::maxShipSize; k++){
+      weight[i] += density[k - 2][i];
+    }
+  }
+  known = grid;
+}
+
+
+// Loads the EMPTY squares of the grid and the squares that are not a MISS or
+// SINK into the empty and open lanes read by AccumulateSize
+template<class V>
+void BasicAIOpponent<V>::ExpandGrid(const Board &grid){
+  const GridKernels &kernels = GridKernels::Active();
+  kernels.ExpandBits(grid.getMask(EMPTY).words, Lanes(), empty);
+  kernels.ExpandBits((~(grid.getMask(MISS) | grid.getMask(SINK))).words, Lanes(), open + padding);
+}
+
+
+// Adds every placement of size k that fits on the grid last given to 
+// ExpandGrid to out[], one direction at a time
+template<class V>
+void BasicAIOpponent<V>::AccumulateSize(int k, int16_t out[]){
+  const GridKernels &kernels = GridKernels::Active();
+  for(int d = 0; d < 4; d++){
+    int offset = dirX[d] * V::Height() + dirY[d];   // lanes between squares of the ship
+    int length = dirX[d] ? V::Width() : V::Height();  // squares in the line the ship lies on
+    const int16_t *coord = dirX[d] ? Tables::density.laneX : Tables::density.laneY;
+    int minCoord = offset < 0 ? k - 1 : 0,          // starting squares that fit k squares
+        maxCoord = offset < 0 ? length - 1 : length - k;
+    kernels.AccumulateDirection(out, empty, open + padding, coord, Lanes(), 
+                                offset, k, minCoord, maxCoord, fits + padding);
+  }
+}
+
+
+// Changes the smallest ship size included in weight to s (the size of the 
+// smallest ship AFLOAT) by adding or removing the density of the sizes in between.
+template<class V>
+void BasicAIOpponent<V>::SetMinSize(int s){
+  for(int i = s; i < minSize; i++){
+    for(int square = 0; square < V::Squares(); square++){
+      weight[square] += density[i - 2][square];
+    }
+  }
+  for(int i = minSize; i < s; i++){
+    for(int square = 0; square < V::Squares(); square++){
+      weight[square] -= density[i - 2][square];
+    }
+  }
+  minSize = s;
+}
+
+
+// Applies the special weighting of a HIT at (x,y) to the immediate surrounding 
+// coordinates. This will check if the additional wighting can be applied UP TO 
+// 2 spaces away, but may not attempt to apply weighting at all if a ship cannot 
+// fit in that direction.
+template<class V>
+void BasicAIOpponent<V>::AddHitWeight(const Board &grid, int x, int y, int16_t tmp[]){
+  int i = Bitboard::Index(x, y),    // square of the HIT
+      row = V::Height();            // distance between horizontally adjacent squares
+  if(EvalUp(grid, x, y, 3)){
+    tmp[i - 1] += 100;
+    tmp[i - 2] += 50;
+  }
+  else if(EvalUp(grid, x, y, 2)){
+    tmp[i - 1] += 100;
+  }
+  if(EvalDown(grid, x, y, 3)){
+    tmp[i + 1] += 100;
+    tmp[i + 2] += 50;
+  }
+  else if(EvalDown(grid, x, y, 2)){
+    tmp[i + 1] += 100;
+  }
+  if(EvalLeft(grid, x, y, 3)){
+    tmp[i - row] += 100;
+    tmp[i - 2 * row] += 50;
+  }
+  else if(EvalLeft(grid, x, y, 2)){
+    tmp[i - row] += 100;
+  }
+  if(EvalRight(grid, x, y, 3)){
+    tmp[i + row] += 100;
+    tmp[i + 2 * row] += 50;
+  }
+  else if(EvalRight(grid, x, y, 2)){
+    tmp[i + row] += 100;
+  }
+}
+
+
+// Used solely in debugging
+// Displays the weight each square is given by the AI
+// Would have used DisplayGrid, but requirements are different
+// i.e. DisplayProbabilityGrid prints numbers not symbols
+// and takes in an array of ints indexed like a Bitboard, not squares.
+// Thought about implementing a conversion constructor, but decided
+// that solution was less efficient than constructing a new function
+/* EX:
+    COMP PROBABILITY GRID
+        1   2   3   4   5   6   7   8   9  10
+      -----------------------------------------
+    A | 8 | 15| 20| 23| 24| 24| 23| 20| 15| 8 |
+      -----------------------------------------
+    B | 15| 22| 27| 30| 31| 31| 30| 27| 22| 15|
+      -----------------------------------------
+    C | 20| 27| 32| 35| 36| 36| 35| 32| 27| 20|
+      -----------------------------------------
+    D | 23| 30| 35| 38| 39| 39| 38| 35| 30| 23|
+      -----------------------------------------
+    E | 24| 31| 36| 39| 40| 40| 39| 36| 31| 24|
+      -----------------------------------------
+    F | 24| 31| 36| 39| 40| 40| 39| 36| 31| 24|
+      -----------------------------------------
+    G | 23| 30| 35| 38| 39| 39| 38| 35| 30| 23|
+      -----------------------------------------
+    H | 20| 27| 32| 35| 36| 36| 35| 32| 27| 20|
+      -----------------------------------------
+    I | 15| 22| 27| 30| 31| 31| 30| 27| 22| 15|
+      -----------------------------------------
+    J | 8 | 15| 20| 23| 24| 24| 23| 20| 15| 8 |
+      -----------------------------------------
+*/
+template<class V>
+void BasicAIOpponent<V>::DisplayProbabilityGrid(const int16_t grid[]){
+  string line = "  " + string(4 * V::Width() + 1, '-');    // line between rows of the grid
+  cout << "\nCOMP PROBABILITY GRID";
+  cout << "\n  ";
+  for (int col = 0; col < V::Width(); col++) {
+    cout << (col == 0 ? "" : " ") << setw(3) << col + 1;
+  }
+  cout << endl;
+  cout << line << endl;
+  for (int row = 0; row < V::Height(); row++) {
+    for (int col = 0; col < V::Width(); col++) {
+      int weight = grid[Bitboard::Index(col, row)];
+      if (col == 0){
+        cout << char('A' + row) << " ";
+        cout << "|";
+      }
+      if(weight < 100){
+        cout << " ";
+      }
+      cout  << weight;
+      if(weight < 10){
+        cout << " ";
+      }
+      cout << "|";
+    }
+    cout << "\n";
+    if (row < V::Height() - 1) {
+      cout << line << endl;
+    }
+  }
+    cout << line << "\n" << endl;
+}
+
+
+// The Eval functions check whether a ship of size 's' can fit in a direction 
+// from point (x,y): the ship must stay on the grid and the squares between
+// (x,y) and the ship's far end cannot be a MISS or a SINK.
+// Each check is a lookup in the DensityPlacementTable followed by a single 
+// mask test against the blocked squares of the grid.
+template<class V>
+bool EvalDirection(const BasicBoard<V> &grid, int d, int x, int y, int s){
+  const DensityPlacementTable<V> &table = PlacementTables<V>::density;
+  int p = table.at[d][s][BasicBitboard<V>::Index(x, y)];    // placement in the table
+  return p >= 0 && !(table.interior[p] & (grid.getMask(MISS) | grid.getMask(SINK))).Any();
+}
+
+
+//Checks to see if a ship of size 's' can fit vertically above point (x,y)
+template<class V>
+bool BasicAIOpponent<V>::EvalUp(const Board &grid, int x, int y, int s){
+  return EvalDirection(grid, 0, x, y, s);
+}
+
+
+//Checks to see if a ship of size 's' can fit vertically below point (x,y)
+template<class V>
+bool BasicAIOpponent<V>::EvalDown(const Board &grid, int x, int y, int s){
+  return EvalDirection(grid, 1, x, y, s);
+}
+
+
+//Checks to see if a ship of size 's' can fit horizontally to the right of point (x,y)
+template<class V>
+bool BasicAIOpponent<V>::EvalRight(const Board &grid, int x, int y, int s){
+  return EvalDirection(grid, 3, x, y, s);
+}
+
+
+//Checks to see if a ship of size 's' can fit horizontally to the left of point (x,y)
+template<class V>
+bool BasicAIOpponent<V>::EvalLeft(const Board &grid, int x, int y, int s){
+  return EvalDirection(grid, 2, x, y, s);
+}
+
+
+//Used by AI to determine the size of the smallest ship afloat in the given fleet
+template<class V>
+int BasicAIOpponent<V>::SmallestShipAlive(const Fleet &fleet){
+  int small = V::maxShipSize;   // variable to hold the size of the smallest ship
+  int tmpInt;                   // temporary int used to make comparisons to small
+  for(int i = 0; i < fleet.getNumShips(); i++){
+    if(fleet[i].getShipState() == AFLOAT){
+      tmpInt = fleet[i].getSize();
+      if(tmpInt < small){
+        small = tmpInt;
       }
-      case 2: { 
-        ManualPlacement();
-        choiceMade = true;
-        break;
+    }
+  }
+  return small;
+}
+
+
+/*
+  Below exists all functions used for the GridKernels.
+  The scalar kernels are the reference; the SSE4.1 and AVX2 kernels do the
+  same work 8 or 16 lanes at a time and are only called when the CPU reports
+  support for their instruction set. With the vector kernels a whole rebuild
+  of the classic density map costs about as much as updating 2-3 squares one
+  placement at a time, hence their lower rebuild limits.
+*/
+
+
+// Sets out[i] to bit i of words
+void ExpandBitsScalar(const uint64_t *words, int lanes, int16_t *out){
+  for(int i = 0; i < lanes; i++){
+    out[i] = (words[i / 64] >> (i % 64)) & 1;
+  }
+}
+
+
+// Finds every placement of size k heading offset lanes per square that fits,
+// then adds each one to the lanes it counts. A lane gathers the placements
+// starting 0 to k - 2 steps behind it instead of each placement scattering
+// to its lanes, so that whole rows and columns are added at once.
+void AccumulateDirectionScalar(int16_t *density, const int16_t *empty, const int16_t *open,
+                               const int16_t *coord, int lanes, int offset, int k,
+                               int minCoord, int maxCoord, int16_t *fits){
+  for(int i = 0; i < lanes; i++){
+    int16_t fit = empty[i] & (coord[i] >= minCoord && coord[i] <= maxCoord);
+    for(int j = 1; j < k - 1; j++){
+      fit &= open[i + j * offset];
+    }
+    fits[i] = fit;
+  }
+  for(int i = 0; i < lanes; i++){
+    int16_t sum = density[i];    // placements counted at lane i
+    for(int j = 0; j < k - 1; j++){
+      sum += fits[i - j * offset];
+    }
+    density[i] = sum;
+  }
+}
+
+
+// Scores every lane and returns the first lane with the highest score
+int ScoreTargetScalar(int16_t *score, const int16_t *weight, const int16_t *fired,
+                      const int16_t *shotDown, int lanes){
+  int high = 0,         // highest score so far
+      highLane = 0;     // lane it was found in
+  for(int i = 0; i < lanes; i++){
+    score[i] = fired[i] ? 0 : score[i] + weight[i] + shotDown[i] * 1000;
+    if(score[i] > high){
+      high = score[i];
+      highLane = i;
+    }
+  }
+  return highLane;
+}
+
+
+bool ScalarSupported() {return true;}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.1")))
+void ExpandBitsSSE41(const uint64_t *words, int lanes, int16_t *out){
+  const __m128i bits = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);   // bit tested by each lane
+  for(int i = 0; i < lanes; i += 8){
+    __m128i chunk = _mm_set1_epi16((words[i / 64] >> (i % 64)) & 0xFF);
+    __m128i set = _mm_cmpeq_epi16(_mm_and_si128(chunk, bits), bits);
+    _mm_storeu_si128((__m128i *)(out + i), _mm_srli_epi16(set, 15));
+  }
+}
+
+
+__attribute__((target("sse4.1")))
+void AccumulateDirectionSSE41(int16_t *density, const int16_t *empty, const int16_t *open,
+                              const int16_t *coord, int lanes, int offset, int k,
+                              int minCoord, int maxCoord, int16_t *fits){
+  const __m128i low = _mm_set1_epi16(minCoord - 1), high = _mm_set1_epi16(maxCoord + 1);
+  for(int i = 0; i < lanes; i += 8){
+    __m128i c = _mm_loadu_si128((const __m128i *)(coord + i));
+    __m128i fit = _mm_and_si128(_mm_cmpgt_epi16(c, low), _mm_cmpgt_epi16(high, c));
+    fit = _mm_and_si128(fit, _mm_loadu_si128((const __m128i *)(empty + i)));
+    for(int j = 1; j < k - 1; j++){
+      fit = _mm_and_si128(fit, _mm_loadu_si128((const __m128i *)(open + i + j * offset)));
+    }
+    _mm_storeu_si128((__m128i *)(fits + i), fit);
+  }
+  for(int i = 0; i < lanes; i += 8){
+    __m128i sum = _mm_loadu_si128((const __m128i *)(density + i));
+    for(int j = 0; j < k - 1; j++){
+      sum = _mm_add_epi16(sum, _mm_loadu_si128((const __m128i *)(fits + i - j * offset)));
+    }
+    _mm_storeu_si128((__m128i *)(density + i), sum);
+  }
+}
+
+
+// Scores are never negative, so the highest score is found with PHMINPOSUW
+// on 0x7FFF - score
+__attribute__((target("sse4.1")))
+int ScoreTargetSSE41(int16_t *score, const int16_t *weight, const int16_t *fired,
+                     const int16_t *shotDown, int lanes){
+  const __m128i one = _mm_set1_epi16(1), bonus = _mm_set1_epi16(1000), top = _mm_set1_epi16(0x7FFF);
+  __m128i high = _mm_setzero_si128();   // highest score of each lane position
+  for(int i = 0; i < lanes; i += 8){
+    __m128i s = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(score + i)),
+                              _mm_loadu_si128((const __m128i *)(weight + i)));
+    s = _mm_add_epi16(s, _mm_mullo_epi16(_mm_loadu_si128((const __m128i *)(shotDown + i)), bonus));
+    s = _mm_and_si128(s, _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(fired + i)), one));
+    _mm_storeu_si128((__m128i *)(score + i), s);
+    high = _mm_max_epi16(high, s);
+  }
+  __m128i best = _mm_set1_epi16(0x7FFF - _mm_extract_epi16(_mm_minpos_epu16(_mm_sub_epi16(top, high)), 0));
+  for(int i = 0; i < lanes; i += 8){
+    int found = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(score + i)), best));
+    if(found){
+      return i + __builtin_ctz(found) / 2;
+    }
+  }
+  return 0;
+}
+
+
+bool SSE41Supported() {return __builtin_cpu_supports("sse4.1");}
+
+
+__attribute__((target("avx2")))
+void ExpandBitsAVX2(const uint64_t *words, int lanes, int16_t *out){
+  const __m256i bits = _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
+                                         4096, 8192, 16384, -32768);   // bit tested by each lane
+  for(int i = 0; i < lanes; i += 16){
+    __m256i chunk = _mm256_set1_epi16(int16_t(words[i / 64] >> (i % 64)));
+    __m256i set = _mm256_cmpeq_epi16(_mm256_and_si256(chunk, bits), bits);
+    _mm256_storeu_si256((__m256i *)(out + i), _mm256_srli_epi16(set, 15));
+  }
+}
+
+
+__attribute__((target("avx2")))
+void AccumulateDirectionAVX2(int16_t *density, const int16_t *empty, const int16_t *open,
+                             const int16_t *coord, int lanes, int offset, int k,
+                             int minCoord, int maxCoord, int16_t *fits){
+  const __m256i low = _mm256_set1_epi16(minCoord - 1), high = _mm256_set1_epi16(maxCoord + 1);
+  for(int i = 0; i < lanes; i += 16){
+    __m256i c = _mm256_loadu_si256((const __m256i *)(coord + i));
+    __m256i fit = _mm256_and_si256(_mm256_cmpgt_epi16(c, low), _mm256_cmpgt_epi16(high, c));
+    fit = _mm256_and_si256(fit, _mm256_loadu_si256((const __m256i *)(empty + i)));
+    for(int j = 1; j < k - 1; j++){
+      fit = _mm256_and_si256(fit, _mm256_loadu_si256((const __m256i *)(open + i + j * offset)));
+    }
+    _mm256_storeu_si256((__m256i *)(fits + i), fit);
+  }
+  for(int i = 0; i < lanes; i += 16){
+    __m256i sum = _mm256_loadu_si256((const __m256i *)(density + i));
+    for(int j = 0; j < k - 1; j++){
+      sum = _mm256_add_epi16(sum, _mm256_loadu_si256((const __m256i *)(fits + i - j * offset)));
+    }
+    _mm256_storeu_si256((__m256i *)(density + i), sum);
+  }
+}
+
+
+__attribute__((target("avx2")))
+int ScoreTargetAVX2(int16_t *score, const int16_t *weight, const int16_t *fired,
+                    const int16_t *shotDown, int lanes){
+  const __m256i one = _mm256_set1_epi16(1), bonus = _mm256_set1_epi16(1000);
+  __m256i high = _mm256_setzero_si256();   // highest score of each lane position
+  for(int i = 0; i < lanes; i += 16){
+    __m256i s = _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(score + i)),
+                                 _mm256_loadu_si256((const __m256i *)(weight + i)));
+    s = _mm256_add_epi16(s, _mm256_mullo_epi16(_mm256_loadu_si256((const __m256i *)(shotDown + i)), bonus));
+    s = _mm256_and_si256(s, _mm256_sub_epi16(_mm256_loadu_si256((const __m256i *)(fired + i)), one));
+    _mm256_storeu_si256((__m256i *)(score + i), s);
+    high = _mm256_max_epi16(high, s);
+  }
+  // Folds the 16 lane positions down to one
+  __m128i fold = _mm_max_epi16(_mm256_castsi256_si128(high), _mm256_extracti128_si256(high, 1));
+  fold = _mm_max_epi16(fold, _mm_shuffle_epi32(fold, 0x4E));
+  fold = _mm_max_epi16(fold, _mm_shuffle_epi32(fold, 0xB1));
+  fold = _mm_max_epi16(fold, _mm_srli_epi32(fold, 16));
+  __m256i best = _mm256_set1_epi16(_mm_extract_epi16(fold, 0));
+  for(int i = 0; i < lanes; i += 16){
+    unsigned found = _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i *)(score + i)), best));
+    if(found){
+      return i + __builtin_ctz(found) / 2;
+    }
+  }
+  return 0;
+}
+
+
+bool AVX2Supported() {return __builtin_cpu_supports("avx2");}
+#endif
+
+
+const GridKernels GridKernels::all[] = {
+#if defined(__x86_64__) || defined(__i386__)
+  {"avx2", AVX2Supported, 2, ExpandBitsAVX2, AccumulateDirectionAVX2, ScoreTargetAVX2},
+  {"sse4.1", SSE41Supported, 3, ExpandBitsSSE41, AccumulateDirectionSSE41, ScoreTargetSSE41},
+#endif
+  {"scalar", ScalarSupported, 12, ExpandBitsScalar, AccumulateDirectionScalar, ScoreTargetScalar}
+};
+const int GridKernels::numKernels = sizeof(all) / sizeof(all[0]);
+
+
+// Returns the kernels chosen by Select, or else the first supported ones
+const GridKernels &GridKernels::Active(){
+  static const GridKernels *best = [](){
+    for(int i = 0; i < numKernels; i++){
+      if(all[i].Supported()){
+        return &all[i];
       }
-      case 3: {
-        cout << "Goodbye!" << endl;
-        LogExit();
-        exit(0);
+    }
+    return &all[numKernels - 1];
+  }();
+  return active ? *active : *best;
+}
+
+
+// Makes the kernels with the given name active for every AI.
+// Returns false if there are none or the CPU does not support them.
+bool GridKernels::Select(const string &name){
+  for(int i = 0; i < numKernels; i++){
+    if(name == all[i].name && all[i].Supported()){
+      active = &all[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/*
+  Below exists all functions used for the MonteCarloAI class
+*/
+
+// Sets the limits on the work done per decision
+template<class V>
+BasicMonteCarloAI<V>::BasicMonteCarloAI(int samples, int budget) : generator(NewSeed()){
+  maxSamples = samples;
+  budgetMicros = budget;
+  enumerationLimit = 50000;
+  numShips = 0;
+  total = 0;
+}
+
+
+// Computes how likely each square is to contain an AFLOAT ship and returns 
+// the most likely square that has not been fired upon. Squares are compared 
+// in the same order as AIOpponent::EvaluateGrid, so ties go to the same square.
+template<class V>
+pair<int, int> BasicMonteCarloAI<V>::ChooseTarget(const Board &grid, const Fleet &enemyFleet){
+  PROFILE_SCOPE(PHASE_AI);
+  Bitboard blocked = grid.getMask(MISS) | grid.getMask(SINK);         // squares no AFLOAT ship can use
+  Bitboard mustCover = grid.getMask(HIT) | grid.getMask(SHOT_DOWN);   // squares known to hold AFLOAT ships
+  Bitboard fired = blocked | grid.getMask(HIT);                      // squares never fired upon again
+  double searchSize = 1;                                             // fleet placements before overlaps are removed
+  int sizes[V::maxShips];                                            // sizes of the AFLOAT ships
+  numShips = 0;
+  for(const Ship &ship : enemyFleet){
+    if(ship.getShipState() == AFLOAT){
+      sizes[numShips++] = ship.getSize();
+    }
+  }
+  // Largest ships first: they have the fewest candidates, which prunes enumeration early
+  sort(sizes, sizes + numShips, greater<int>());
+  for(int k = 0; k < numShips; k++){
+    candidates[k].clear();
+    for(int p = Tables::ship.first[sizes[k]]; p < Tables::ship.first[sizes[k] + 1]; p++){
+      if(!(Tables::ship.masks[p] & blocked).Any()){
+        candidates[k].push_back(Tables::ship.masks[p]);
       }
-      //Bulletproof - Does not accept inputs other than 1,2, or 3
-      default: cout << "\nInvalid entry, please enter either 1, 2, or 3." 
-                    << endl;
-        break;
     }
+    searchSize *= candidates[k].size();
+  }
+  for(int i = 0; i < V::Squares(); i++){
+    counts[i] = 0;
+  }
+  total = 0;
+  if(searchSize <= enumerationLimit){
+    Enumerate(0, Bitboard(), mustCover, fired);
+  }
+  else{
+    Sample(mustCover, fired);
+  }
+  if(total == 0){
+    return fallback.ChooseTarget(grid, enemyFleet);
+  }
+  long high = -1;             // most occupied count found so far
+  int highX = 0, highY = 0;   // location of the most occupied square
+  for(int x = 0; x < V::Width(); x++){
+    for(int y = 0; y < V::Height(); y++){
+      int i = Bitboard::Index(x, y);
+      if(!fired.Test(i) && counts[i] > high){
+        high = counts[i];
+        highX = x;
+        highY = y;
+      }
+    }
+  }
+  return make_pair(highY, highX);
+}
+
+
+// Visits every fleet placement of the ships from index ship onward that does 
+// not overlap the squares already occupied, counting the ones that cover 
+// every square in mustCover.
+template<class V>
+void BasicMonteCarloAI<V>::Enumerate(int ship, Bitboard occupied, Bitboard mustCover, Bitboard fired){
+  if(ship == numShips){
+    if(!(mustCover & ~occupied).Any()){
+      Count(occupied, fired);
+    }
+    return;
+  }
+  for(Bitboard placement : candidates[ship]){
+    if(!(placement & occupied).Any()){
+      Enumerate(ship + 1, occupied | placement, mustCover, fired);
+    }
+  }
+}
+
+
+// Draws random fleet placements, one candidate per ship chosen uniformly and 
+// independently, and counts those without overlapping ships that cover every
+// square in mustCover. Rejecting the rest leaves every agreeing fleet 
+// placement equally likely.
+template<class V>
+void BasicMonteCarloAI<V>::Sample(Bitboard mustCover, Bitboard fired){
+  auto start = chrono::steady_clock::now();
+  for(int n = 0; n < maxSamples; n++){
+    // The clock is only read every 256 samples to keep its cost out of the loop
+    if(budgetMicros > 0 && n % 256 == 255 
+       && chrono::steady_clock::now() - start > chrono::microseconds(budgetMicros)){
+      break;
+    }
+    Bitboard occupied;    // squares covered by the ships placed so far
+    bool valid = true;    // false once two ships overlap
+    for(int k = 0; k < numShips && valid; k++){
+      Bitboard placement = candidates[k][generator.Below(candidates[k].size())];
+      valid = !(placement & occupied).Any();
+      occupied |= placement;
+    }
+    if(valid && !(mustCover & ~occupied).Any()){
+      Count(occupied, fired);
+    }
+  }
+}
+
+
+// Records one fleet placement agreeing with the grid
+template<class V>
+void BasicMonteCarloAI<V>::Count(Bitboard occupied, Bitboard fired){
+  Bitboard open = occupied & ~fired;    // occupied squares that can still be fired upon
+  while(open.Any()){
+    counts[open.LowestBit()]++;
+    open.ClearLowestBit();
+  }
+  total++;
+}
+
+
+/*
+  Below exists all functions used for headless simulation.
+  Games are played AI vs AI with no terminal input or output so that changes
+  to the targeting algorithm can be measured over a large number of games.
+*/
+
+// Plays numGames complete games of the given Gametype, with one targeting 
+// strategy firing on the player's behalf against the computer's strategy.
+// The games are divided into batches and played by numThreads workers, each 
+// with its own Game from a pool, targeting strategies and statistics. Game number i is 
+// seeded with seed + i, so the results do not depend on which thread played 
+// which game (unless a MonteCarloAI runs out of time budget).
+// Returns the results merged from every worker.
+template<class V>
+SimulationStats RunSimulation(Gametype gt, const SimulationOptions &options){
+  const long batchSize = 64;                      // games handed out at a time
+  long numGames = options.numGames;               // games to play
+  int numThreads = options.numThreads;            // number of worker threads
+  vector<WorkQueue> queues(numThreads);           // one queue of batches per worker
+  vector<SimulationStats> results(numThreads);    // statistics gathered by each worker
+  vector<thread> workers;                         // worker threads
+  SimulationStats stats;                          // merged results to be returned
+  BasicGamePool<V> pool(numThreads);              // one game for each worker
+  // Deals the batches out round robin so every worker starts with a fair share
+  for(long first = 0, n = 0; first < numGames; first += batchSize, n++){
+    queues[n % numThreads].Push(make_pair(first, min(first + batchSize, numGames)));
+  }
+  auto start = chrono::steady_clock::now();
+  for(int i = 1; i < numThreads; i++){
+    workers.push_back(thread(SimulationWorker<V>, gt, cref(options), i, ref(queues), ref(pool), 
+                             ref(results[i])));
+  }
+  SimulationWorker<V>(gt, options, 0, queues, pool, results[0]);
+  for(thread &worker : workers){
+    worker.join();
+  }
+  for(const SimulationStats &result : results){
+    stats.Merge(result);
+  }
+  stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  stats.seed = options.seed;
+  return stats;
+}
+
+
+// Body of a simulation worker thread.
+// Plays every batch in queues[id], then steals batches from the other workers'
+// queues until no work is left anywhere. No batches are added once the workers
+// have started, so finding every queue empty means the simulation is done.
+// The worker plays every game on one game from pool, Reset between games.
+template<class V>
+void SimulationWorker(Gametype gt, const SimulationOptions &options, int id, 
+                      vector<WorkQueue> &queues, BasicGamePool<V> &pool, SimulationStats &stats){
+  SimulationStats local;        // statistics kept off the shared vector while playing
+  // AIs firing on the player's and the computer's behalf
+  unique_ptr<BasicTargetingStrategy<V> > userAI = NewStrategy<V>(options.userAI, options.samples, 
+                                                                 options.budgetMicros);
+  unique_ptr<BasicTargetingStrategy<V> > compAI = NewStrategy<V>(options.compAI, options.samples, 
+                                                                 options.budgetMicros);
+  pair<long, long> batch;       // range of games currently being played
+  int shots;                    // shots the winner needed to win one game
+  int numQueues = queues.size();
+  GameLogger log;               // log of every game this worker plays
+  if(!options.logPath.empty() && !log.Open(options.logPath + "." + to_string(id))){
+    cerr << "Could not open " << options.logPath << "." << id << endl;
+  }
+  unique_ptr<BasicGame<V> > game = pool.Acquire(gt, options.seed);   // game every batch is played on
+  game->setCompStrategy(compAI.get());
+  if(log.IsOpen()){
+    game->setLogger(&log);
+  }
+  game->setRecorder(options.recorder);
+  while(true){
+    bool found = queues[id].Pop(batch);
+    for(int i = 1; i < numQueues && !found; i++){
+      found = queues[(id + i) % numQueues].Steal(batch);
+    }
+    if(!found){
+      break;
+    }
+    for(long n = batch.first; n < batch.second; n++){
+      game->Reset(gt, options.seed + n);
+      Player winner = game->AutoPlay(*userAI, shots);
+      local.Record(winner, shots);
+      local.randomDraws += game->getRandomDraws();
+    }
+  }
+  pool.Release(move(game));
+  stats = local;
+}
+
+
+// Adds the outcome of one game to the statistics
+void SimulationStats::Record(Player winner, int shots){
+  if(winner == USER){
+    userWins++;
+  }
+  else{
+    compWins++;
+  }
+  if(shots >= (int)shotsToWin.size()){
+    shotsToWin.resize(shots + 1, 0);
+  }
+  shotsToWin[shots]++;
+  totalShots += shots;
+  games++;
+}
+
+
+// Adds the games recorded in other to these statistics
+void SimulationStats::Merge(const SimulationStats &other){
+  games += other.games;
+  userWins += other.userWins;
+  compWins += other.compWins;
+  totalShots += other.totalShots;
+  randomDraws += other.randomDraws;
+  if(other.shotsToWin.size() > shotsToWin.size()){
+    shotsToWin.resize(other.shotsToWin.size(), 0);
+  }
+  for(size_t n = 0; n < other.shotsToWin.size(); n++){
+    shotsToWin[n] += other.shotsToWin[n];
+  }
+}
+
+
+// Adds a batch to the back of the queue
+void WorkQueue::Push(pair<long, long> batch){
+  lock_guard<mutex> guard(lock);
+  batches.push_back(batch);
+}
+
+
+// Takes the batch at the front of the queue; used by the queue's owner.
+// Returns false if the queue is empty.
+bool WorkQueue::Pop(pair<long, long> &batch){
+  lock_guard<mutex> guard(lock);
+  if(batches.empty()){
+    return false;
+  }
+  batch = batches.front();
+  batches.pop_front();
+  return true;
+}
+
+
+// Takes the batch at the back of the queue; used by other workers.
+// Returns false if the queue is empty.
+bool WorkQueue::Steal(pair<long, long> &batch){
+  lock_guard<mutex> guard(lock);
+  if(batches.empty()){
+    return false;
+  }
+  batch = batches.back();
+  batches.pop_back();
+  return true;
+}
+
+
+/*
+  Below exists all functions used for benchmarking.
+  Each benchmark times one operation of the engine, repeated until enough 
+  time has passed to give a stable figure, in the manner of google-benchmark.
+*/
+
+// Times the engine's hot paths on variant V and prints the wall clock and CPU
+// time each operation took along with the number of operations timed:
+// * EvaluateGrid on grids with 0%, 20% and 40% of the squares fired upon, 
+//   which rebuilds the density map for every grid (every empty grid is the 
+//   same, so the 0% case only scores the grid), and on the grid of every 
+//   turn of a game in order, which updates the map as a game does
+// * RandomPlacement of one fleet, including the Reset of the game
+// * GetShip, CheckHit and ShipHit per shot
+// * DisplayGrid printing a grid into a stream that discards it
+// * LogFire and LogMiss writing to a GameLogger on /dev/null
+// * a complete heuristic AI vs heuristic AI game of every Gametype
+// * the classic game again with both AIs sharing a TranspositionTable of 
+//   --tt-size, emptied before each run, followed by the table's hit rate 
+//   and the time it saved per game
+// * the classic game again with both AIs consulting the --book opening 
+//   book, if one was given, followed by its hit rate and the time it saved
+// Every other benchmark runs without a TranspositionTable or book. Only the 
+// benchmarks whose name contains filter are run. Each one runs for at least
+// minSeconds. The results are also written to jsonPath if given.
+// Returns 1 if the results could not be written.
+template<class V>
+int RunBenchmarks(double minSeconds, const string &filter, const string &jsonPath){
+  using Board = BasicBoard<V>;
+  const int numBoards = 64;                 // grids cycled through by the grid benchmarks
+  const int numFills = 3;                   // fill levels of 0%, 20% and 40%
+  const char *typeNames[] = {"classic", "multifire", "cruise", "hardcore"};
+  BasicGamePool<V> pool(1);
+  unique_ptr<BasicGame<V> > game = pool.Acquire(CLASSIC, 1);   // game every benchmark plays on
+  BasicAIOpponent<V> ai;                    // heuristic AI the benchmarks fire with
+  BasicAIOpponent<V> compAI;                // and the computer fires back with in a Game
+  BasicAIOpponent<V> cachedAI[2];           // user and computer AIs sharing table
+  TranspositionTable<V> table(transpositionBytes);   // table of the cached Game benchmark
+  long probes = 0, hits = 0;                // lookups in table during the last run, and hits
+  BasicAIOpponent<V> bookAI[2];             // user and computer AIs consulting the opening book
+  const OpeningBook<V> *book = OpeningBook<V>::Shared();   // book of the book Game benchmark
+  long bookProbes = 0, bookHits = 0;        // lookups in book during the last run, and hits
+  NullBuffer null;                          // discards what DisplayGrid prints
+  GameLogger log;                           // logger the Log benchmark writes to
+  vector<Board> fillBoards[numFills];       // computer's targeting grids at each fill level
+  vector<Board> turnBoards;                 // computer's targeting grid after every turn of 8 games
+  vector<pair<int, int> > squares;          // random squares as (column, row)
+  vector<int> order;                        // every square in random order
+  vector<pair<string, function<void(BenchmarkState &)> > > benchmarks;
+  vector<BenchmarkResult> results;
+  RandomGenerator rng(1);
+  ai.setCache(nullptr);
+  ai.setBook(nullptr);
+  compAI.setCache(nullptr);
+  compAI.setBook(nullptr);
+  for(BasicAIOpponent<V> &cached : cachedAI){
+    cached.setCache(&table);
+    cached.setBook(nullptr);
+  }
+  for(BasicAIOpponent<V> &booked : bookAI){
+    booked.setCache(nullptr);
+  }
+  game->setCompStrategy(&compAI);
+
+  // Places both fleets of a new classic game
+  auto placeFleets = [&](uint64_t seed){
+    game->Reset(CLASSIC, seed);
+    game->ConstructFleets();
+    game->RandomPlacement(USER);
+    game->RandomPlacement(COMP);
+  };
+  // The computer fires at the player's fleet until it is destroyed, saving 
+  // the targeting grid at every fill level and after every turn
+  for(uint64_t seed = 1; (int)fillBoards[numFills - 1].size() < numBoards; seed++){
+    placeFleets(seed);
+    for(int fired = 0; !game->IsFleetDestroyed(USER); fired += game->AITurn(COMP, ai)){
+      for(int level = 0; level < numFills; level++){
+        if(fired == V::Squares() * level / 5 && (int)fillBoards[level].size() < numBoards){
+          fillBoards[level].push_back(game->getTargeting(COMP));
+        }
+      }
+      if(seed <= 8){
+        turnBoards.push_back(game->getTargeting(COMP));
+      }
+    }
+  }
+  for(int i = 0; i < 1024; i++){
+    squares.push_back(make_pair(rng.Below(V::Width()), rng.Below(V::Height())));
+  }
+  for(int i = 0; i < V::Squares(); i++){
+    order.push_back(i);
+  }
+  for(int i = V::Squares() - 1; i > 0; i--){
+    swap(order[i], order[rng.Below(i + 1)]);
+  }
+
+  for(int level = 0; level < numFills; level++){
+    benchmarks.push_back(make_pair("EvaluateGrid/fill:" + to_string(level * 20) + "%", 
+                                   [&, level](BenchmarkState &state){
+      for(long i = 0; i < state.getIterations(); i++){
+        KeepResult(ai.EvaluateGrid(fillBoards[level][i % numBoards], 2));
+      }
+    }));
+  }
+  benchmarks.push_back(make_pair("EvaluateGrid/turn", [&](BenchmarkState &state){
+    for(long i = 0; i < state.getIterations(); i++){
+      KeepResult(ai.EvaluateGrid(turnBoards[i % turnBoards.size()], 2));
+    }
+  }));
+  // Evaluates the 20% boards all at once; the time is for the whole batch
+  benchmarks.push_back(make_pair("EvaluateBatch/fill:20%/" + to_string(numBoards), [&](BenchmarkState &state){
+    BasicBoardBatch<V> batch;           // the 20% boards
+    pair<int, int> targets[numBoards];  // target chosen on each board
+    state.PauseTiming();
+    for(const Board &grid : fillBoards[1]){
+      batch.Add(grid, 2);
+    }
+    state.ResumeTiming();
+    for(long i = 0; i < state.getIterations(); i++){
+      ai.EvaluateBatch(batch, targets);
+      KeepResult(targets);
+    }
+  }));
+  benchmarks.push_back(make_pair("RandomPlacement", [&](BenchmarkState &state){
+    for(long i = 0; i < state.getIterations(); i++){
+      game->Reset(CLASSIC, i);
+      game->ConstructFleets();
+      game->RandomPlacement(USER);
+    }
+  }));
+  benchmarks.push_back(make_pair("GetShip", [&](BenchmarkState &state){
+    state.PauseTiming();
+    placeFleets(1);
+    state.ResumeTiming();
+    for(long i = 0; i < state.getIterations(); i++){
+      KeepResult(game->GetShip(squares[i % squares.size()], USER));
+    }
+  }));
+  // Fires at every square in turn, placing new fleets once all have been fired at
+  benchmarks.push_back(make_pair("CheckHit", [&](BenchmarkState &state){
+    int next = V::Squares();      // position in order of the next target
+    for(long i = 0; i < state.getIterations(); i++){
+      if(next == V::Squares()){
+        state.PauseTiming();
+        placeFleets(i);
+        next = 0;
+        state.ResumeTiming();
+      }
+      int target = order[next++];
+      game->CheckHit(make_pair(target % V::Height(), target / V::Height()), COMP);
+    }
+  }));
+  // Hits every square of the player's fleet in turn, placing new fleets once
+  // all are sunk
+  benchmarks.push_back(make_pair("ShipHit", [&](BenchmarkState &state){
+    vector<int> targets;          // squares of the player's fleet not yet hit
+    for(long i = 0; i < state.getIterations(); i++){
+      if(targets.empty()){
+        state.PauseTiming();
+        placeFleets(i);
+        for(const BasicShip<V> &ship : game->getFleet(USER)){
+          BasicBitboard<V> mask = ship.getMask();
+          for(; mask.Any(); mask.ClearLowestBit()){
+            targets.push_back(mask.LowestBit());
+          }
+        }
+        state.ResumeTiming();
+      }
+      int target = targets.back();
+      targets.pop_back();
+      game->ShipHit(target / V::Height(), target % V::Height(), COMP);
+    }
+  }));
+  benchmarks.push_back(make_pair("DisplayGrid", [&](BenchmarkState &state){
+    state.PauseTiming();
+    placeFleets(1);
+    game->setDisplay(&null);
+    state.ResumeTiming();
+    for(long i = 0; i < state.getIterations(); i++){
+      game->DisplayGrid(fillBoards[numFills - 1][i % numBoards], USER);
+    }
+    state.PauseTiming();
+    game->setDisplay(nullptr);
+  }));
+  benchmarks.push_back(make_pair("LogFire+LogMiss", [&](BenchmarkState &state){
+    state.PauseTiming();
+    log.Open("/dev/null");
+    game->setLogger(&log);
+    state.ResumeTiming();
+    for(long i = 0; i < state.getIterations(); i++){
+      pair<int, int> target = squares[i % squares.size()];
+      game->LogFire(target.first, target.second, COMP);
+      game->LogMiss();
+    }
+    state.PauseTiming();
+    game->setLogger(nullptr);
+    log.Close();
+  }));
+  for(int type = CLASSIC; type <= HARDCORE; type++){
+    benchmarks.push_back(make_pair(string("Game/") + typeNames[type], [&, type](BenchmarkState &state){
+      int shots;                  // shots the winner needed
+      for(long i = 0; i < state.getIterations(); i++){
+        game->Reset(Gametype(type), i);
+        KeepResult(game->AutoPlay(ai, shots));
+      }
+    }));
+  }
+  if(table.Size() > 0){
+    benchmarks.push_back(make_pair("Game/classic/cached", [&](BenchmarkState &state){
+      int shots;                  // shots the winner needed
+      state.PauseTiming();
+      table.Clear();
+      long startProbes = cachedAI[0].getCacheProbes() + cachedAI[1].getCacheProbes(),
+           startHits = cachedAI[0].getCacheHits() + cachedAI[1].getCacheHits();
+      game->setCompStrategy(&cachedAI[1]);
+      state.ResumeTiming();
+      for(long i = 0; i < state.getIterations(); i++){
+        game->Reset(CLASSIC, i);
+        KeepResult(game->AutoPlay(cachedAI[0], shots));
+      }
+      state.PauseTiming();
+      game->setCompStrategy(&compAI);
+      probes = cachedAI[0].getCacheProbes() + cachedAI[1].getCacheProbes() - startProbes;
+      hits = cachedAI[0].getCacheHits() + cachedAI[1].getCacheHits() - startHits;
+    }));
+  }
+  if(book){
+    benchmarks.push_back(make_pair("Game/classic/book", [&](BenchmarkState &state){
+      int shots;                  // shots the winner needed
+      state.PauseTiming();
+      long startProbes = bookAI[0].getBookProbes() + bookAI[1].getBookProbes(),
+           startHits = bookAI[0].getBookHits() + bookAI[1].getBookHits();
+      game->setCompStrategy(&bookAI[1]);
+      state.ResumeTiming();
+      for(long i = 0; i < state.getIterations(); i++){
+        game->Reset(CLASSIC, i);
+        KeepResult(game->AutoPlay(bookAI[0], shots));
+      }
+      state.PauseTiming();
+      game->setCompStrategy(&compAI);
+      bookProbes = bookAI[0].getBookProbes() + bookAI[1].getBookProbes() - startProbes;
+      bookHits = bookAI[0].getBookHits() + bookAI[1].getBookHits() - startHits;
+    }));
+  }
+
+  cout << "\n___________________"
+       << "\n| BENCHMARK        \\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+       << "\nBoard: " << VariantName<V>()
+       << "\n\n" << left << setw(28) << "Benchmark" << right << setw(14) << "Time (ns)" 
+       << setw(14) << "CPU (ns)" << setw(14) << "Iterations" << endl;
+  for(auto &benchmark : benchmarks){
+    if(benchmark.first.find(filter) == string::npos){
+      continue;
+    }
+    BenchmarkResult result = RunBenchmark(benchmark.first, minSeconds, benchmark.second);
+    cout << left << setw(28) << result.name << right << fixed << setprecision(1) 
+         << setw(14) << result.realNs << setw(14) << result.cpuNs << setw(14) << result.iterations << endl;
+    results.push_back(result);
+  }
+  const BenchmarkResult *uncached = nullptr, *cached = nullptr, *booked = nullptr;   // the classic Game benchmarks
+  for(const BenchmarkResult &result : results){
+    if(result.name == "Game/classic"){
+      uncached = &result;
+    }
+    else if(result.name == "Game/classic/cached"){
+      cached = &result;
+    }
+    else if(result.name == "Game/classic/book"){
+      booked = &result;
+    }
+  }
+  if(cached && probes > 0){
+    cout << "\nTransposition table: " << table.Size() << " entries, " << setprecision(1) 
+         << 100.0 * hits / probes << "% of " << probes << " lookups hit";
+    if(uncached){
+      cout << ", " << (uncached->realNs - cached->realNs) / 1000 << " us (" 
+           << 100 * (1 - cached->realNs / uncached->realNs) << "%) saved per game";
+    }
+    cout << endl;
+  }
+  if(booked && bookProbes > 0){
+    cout << "\nOpening book: " << book->Size() << " grids, " << setprecision(1) 
+         << 100.0 * bookHits / bookProbes << "% of " << bookProbes << " lookups hit";
+    if(uncached){
+      cout << ", " << (uncached->realNs - booked->realNs) / 1000 << " us (" 
+           << 100 * (1 - booked->realNs / uncached->realNs) << "%) saved per game";
+    }
+    cout << endl;
+  }
+  pool.Release(move(game));
+  if(!jsonPath.empty() && !WriteBenchmarkJson(jsonPath, VariantName<V>(), minSeconds, results)){
+    cerr << "Could not write " << jsonPath << endl;
+    return 1;
+  }
+  return 0;
+}
+
+
+// Runs body with an increasing number of iterations until one run takes at
+// least minSeconds of wall clock time, and returns the time per operation 
+// of that run. Like google-benchmark, the next run aims 40% past minSeconds
+// and grows at most tenfold.
+template<class F>
+BenchmarkResult RunBenchmark(const string &name, double minSeconds, F body){
+  long iterations = 1;    // operations performed by the next run
+  while(true){
+    BenchmarkState state(iterations);
+    state.ResumeTiming();
+    body(state);
+    state.PauseTiming();
+    double seconds = state.getRealSeconds();
+    if(seconds >= minSeconds || iterations >= 1000000000L){
+      return BenchmarkResult{name, iterations, seconds / iterations * 1e9, 
+                             state.getCpuSeconds() / iterations * 1e9};
+    }
+    double growth = seconds <= minSeconds / 10 ? 10 : minSeconds * 1.4 / seconds;
+    iterations = max(iterations + 1, long(iterations * growth));
+  }
+}
+
+
+// Starts counting time towards the benchmark
+void BenchmarkState::ResumeTiming(){
+  running = true;
+  cpuStart = CpuNow();
+  realStart = chrono::steady_clock::now();
+}
+
+
+// Stops counting time towards the benchmark
+void BenchmarkState::PauseTiming(){
+  if(running){
+    realSeconds += chrono::duration<double>(chrono::steady_clock::now() - realStart).count();
+    cpuSeconds += CpuNow() - cpuStart;
+    running = false;
+  }
+}
+
+
+// Returns the CPU time used by the calling thread in seconds
+double BenchmarkState::CpuNow(){
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+// Writes the results of a benchmark run to path as JSON laid out like the
+// output of google-benchmark, so its compare.py can diff two runs.
+// Returns false if the file could not be written.
+bool WriteBenchmarkJson(const string &path, const string &board, double minSeconds,
+                        const vector<BenchmarkResult> &results){
+  ofstream out(path);
+  time_t now = time(nullptr);
+  tm local;
+  char date[32];          // time of the run in ISO 8601
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime_r(&now, &local));
+  out << "{\n  \"context\": {"
+      << "\n    \"date\": \"" << date << "\","
+      << "\n    \"num_cpus\": " << thread::hardware_concurrency() << ","
+      << "\n    \"board\": \"" << board << "\","
+      << "\n    \"kernels\": \"" << GridKernels::Active().name << "\","
+      << "\n    \"min_time\": " << minSeconds
+      << "\n  },\n  \"benchmarks\": [";
+  for(size_t i = 0; i < results.size(); i++){
+    out << (i ? "," : "") << "\n    {"
+        << "\n      \"name\": \"" << results[i].name << "\","
+        << "\n      \"run_name\": \"" << results[i].name << "\","
+        << "\n      \"run_type\": \"iteration\","
+        << "\n      \"iterations\": " << results[i].iterations << ","
+        << "\n      \"real_time\": " << setprecision(17) << results[i].realNs << ","
+        << "\n      \"cpu_time\": " << results[i].cpuNs << ","
+        << "\n      \"time_unit\": \"ns\""
+        << "\n    }";
   }
-  RandomPlacement(COMP);
+  out << "\n  ]\n}\n";
+  out.close();
+  return !out.fail();
 }
 
 
-//constructs the 5 ships needed for both players
-void Game::ConstructFleets(){
-userFleet.push_back(Ship(5, "CARRIER"));
-userFleet.push_back(Ship(4, "BATTLESHIP"));
-userFleet.push_back(Ship(3, "CRUISER"));
-userFleet.push_back(Ship(3, "SUBMARINE"));
-userFleet.push_back(Ship(2, "DESTROYER"));
+/*
+  Below exists all functions used for the GameServer class and the load test
+  run against it.
+  Both sides are single threaded loops around epoll_wait with non-blocking 
+  sockets. Each response of the server ends with a prompt ending in '?', 
+  which is how the load test knows a response is complete.
+*/
+
+
+// Menu sent to a session that is not playing a game
+const char serverMenu[] = "\n___________________"
+                          "\n| SELECT GAME TYPE \\"
+                          "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
+                          "\nGame type (classic, multifire, cruise or hardcore)?";
 
-compFleet.push_back(Ship(5, "CARRIER"));
-compFleet.push_back(Ship(4, "BATTLESHIP"));
-compFleet.push_back(Ship(3, "CRUISER"));
-compFleet.push_back(Ship(3, "SUBMARINE"));
-compFleet.push_back(Ship(2, "DESTROYER"));
+
+// Raises the limit on open files as far as allowed, since every connection
+// uses a file descriptor
+void RaiseFileLimit(){
+  rlimit limit;
+  if(getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max){
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
 }
 
 
-//loops through the fleet belonging to Player p, randomly places each ship
-void Game::RandomPlacement(Player p){
-  if(p == USER){
-    for(int i = 0; i < 5; i++){
-      RandomPlace(i, p);
+template<class V>
+BasicGameServer<V>::BasicGameServer(const ServerOptions &o) : options(o), epollFd(-1), nextSeed(o.seed) {}
+
+
+template<class V>
+BasicGameServer<V>::~BasicGameServer(){
+  for(unique_ptr<Session> &s : sessions){
+    if(s){
+      close(s->fd);
     }
   }
-  else{
-    // Specification B3 - Random Start
-    for(int i = 0; i < 5; i++){
-      RandomPlace(i, p);
+  for(int fd : listeners){
+    close(fd);
+  }
+  if(!options.unixPath.empty()){
+    unlink(options.unixPath.c_str());
+  }
+  if(epollFd >= 0){
+    close(epollFd);
+  }
+}
+
+
+// Starts listening on the loopback TCP port and the Unix socket given in the
+// options. Returns false if either could not be opened.
+template<class V>
+bool BasicGameServer<V>::Open(){
+  RaiseFileLimit();
+  epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if(epollFd < 0){
+    cerr << "Could not create an epoll instance: " << strerror(errno) << endl;
+    return false;
+  }
+  if(options.port > 0){
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);   // listening socket
+    int one = 1;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if(fd < 0 || bind(fd, (sockaddr *)&address, sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0
+       || !AddListener(fd)){
+      cerr << "Could not listen on port " << options.port << ": " << strerror(errno) << endl;
+      return false;
+    }
+  }
+  if(!options.unixPath.empty()){
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);   // listening socket
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+    unlink(options.unixPath.c_str());
+    if(fd < 0 || bind(fd, (sockaddr *)&address, sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0
+       || !AddListener(fd)){
+      cerr << "Could not listen on " << options.unixPath << ": " << strerror(errno) << endl;
+      return false;
     }
   }
+  return !listeners.empty();
 }
 
 
-// Randomly places the ship at index location shipLoc on the grid
-// TODO: Modularize this code
-void Game::RandomPlace(int shipLoc, Player p){
-  int shipSize;                     // size of the given ship
-  bool placed = false;              // bool ensuring valid placement
-  bool isEmpty;                     // bool ensuring that the desired placement is empty
-  vector<pair<int,int> > shipVec;   // container of coordinates of where the given ship
-                                    // will be placed
-  // Loops until a valid placement occurs
-  // At the beginning of each iteration, random coordinates are generated from 1-10
-  // A direction is then also randomly obtained.
-  // With this direction, a check is performed to see if any of the sqaures in that direction
-  // are already occupied. If all of the necessary squares are EMPTY, the ship is placed
-  // at at those locations.
-  while(!placed){
-    int x = rand() % 10;
-    int y = rand() % 10;
-    if(p == USER){
-      shipSize = userFleet[shipLoc].getSize();
-      if(userShips[x][y].getSquareState() == EMPTY){
-        isEmpty = true;
-        switch (getRandomDirection(x,y, shipSize)){
-          case 1: { //checks right
-            for(int i = x; i < x + shipSize; i++){
-              shipVec.push_back(make_pair(i, y));
-              if(userShips[i][y].getSquareState() != EMPTY){
-                isEmpty = false;
-                break;
-              }
-            }
-            break;
-          }
-          case 2: { //checks down
-            for(int i = y; i < y + shipSize; i++){
-              shipVec.push_back(make_pair(x, i));
-              if(userShips[x][i].getSquareState() != EMPTY){
-                isEmpty = false;
-                break;
-              }
-            }
-            break;
-          }
-          case 3: { //checks left
-            for(int i = x; i > x - shipSize; i--){
-              shipVec.push_back(make_pair(i, y));
-              if(userShips[i][y].getSquareState() != EMPTY){
-                isEmpty = false;
-                break;
-              }
-            }
-            break;
-          }
-          case 4: { //checks up
-            for(int i = y; i > y - shipSize; i--){
-              shipVec.push_back(make_pair(x, i));
-              if(userShips[x][i].getSquareState() != EMPTY){
-                isEmpty = false;
-                break;
-              }
-            }
-            break;
-          }
-          default: isEmpty = false;
-            break;
-        }
-        if(isEmpty){
-          userFleet[shipLoc].setCoords(shipVec);
-          PlaceShip(shipVec, p);
-          LogShipPlace(shipLoc, p);
-          placed = true;
-        }
-        else{
-          shipVec.clear();
-        }
+// Registers a listening socket with epoll
+template<class V>
+bool BasicGameServer<V>::AddListener(int fd){
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0){
+    close(fd);
+    return false;
+  }
+  listeners.push_back(fd);
+  return true;
+}
+
+
+// Serves every connection until SIGINT or SIGTERM, then prints what was 
+// served
+template<class V>
+void BasicGameServer<V>::Run(){
+  const int maxEvents = 256;      // events handled per wait
+  epoll_event events[maxEvents];
+  struct sigaction stop = {};     // sets stopping, interrupting epoll_wait
+  stop.sa_handler = [](int){stopping = 1;};
+  sigaction(SIGINT, &stop, nullptr);
+  sigaction(SIGTERM, &stop, nullptr);
+  cout << "Serving " << VariantName<V>() << " games";
+  if(options.port > 0){
+    cout << " on 127.0.0.1:" << options.port;
+  }
+  if(!options.unixPath.empty()){
+    cout << (options.port > 0 ? " and " : " on ") << options.unixPath;
+  }
+  cout << endl;
+  while(!stopping){
+    int n = epoll_wait(epollFd, events, maxEvents, -1);
+    for(int i = 0; i < n; i++){
+      int fd = events[i].data.fd;
+      if(find(listeners.begin(), listeners.end(), fd) != listeners.end()){
+        Accept(fd);
+        continue;
       }
-    }
-    else{
-      //Evaluation for computer ships
-      shipSize = compFleet[shipLoc].getSize();
-      if(compShips[x][y].getSquareState() == EMPTY){
-        isEmpty = true;
-        switch (getRandomDirection(x,y, shipSize)){
-          case 1: { //checks right
-            for(int i = x; i < x + shipSize; i++){
-              shipVec.push_back(make_pair(i, y));
-              if(compShips[i][y].getSquareState() != EMPTY){
-                isEmpty = false;
-              }
-            }
-            break;
-          }
-          case 2: { //checks down
-            for(int i = y; i < y + shipSize; i++){
-              shipVec.push_back(make_pair(x, i));
-              if(compShips[x][i].getSquareState() != EMPTY){
-                isEmpty = false;
-              }
-            }
-            break;
-          }
-          case 3: { //checks left
-            for(int i = x; i > x - shipSize; i--){
-              shipVec.push_back(make_pair(i, y));
-              if(compShips[i][y].getSquareState() != EMPTY){
-                isEmpty = false;
-              }
-            }
-            break;
-          }
-          case 4: { //checks up
-            for(int i = y; i > y - shipSize; i--){
-              shipVec.push_back(make_pair(x, i));
-              if(compShips[x][i].getSquareState() != EMPTY){
-                isEmpty = false;
-              }
-            }
-            break;
-          }
-          case 0: isEmpty = false;
-        }
-        // Places ship
-        if(isEmpty == true){
-          compFleet[shipLoc].setCoords(shipVec);
-          PlaceShip(shipVec, p);
-          placed = true;
-          LogShipPlace(shipLoc, p);
-        }
-        else{
-          shipVec.clear();
-        }
+      // The session may have been closed by an earlier event of this batch
+      if(fd < (int)sessions.size() && sessions[fd] && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))){
+        Receive(*sessions[fd]);
+      }
+      if(fd < (int)sessions.size() && sessions[fd] && (events[i].events & EPOLLOUT)){
+        Send(*sessions[fd]);
       }
     }
   }
+  cout << "\nPeak sessions:     " << peakSessions
+       << "\nGames started:     " << gamesStarted
+       << "\nTurns played:      " << turnsPlayed
+       << "\nPeak frame memory: " << FrameAllocator::getPeakBytes() << " bytes";
+  if(peakSessions > 0){
+    cout << " (" << FrameAllocator::getPeakBytes() / peakSessions << " per session)";
+  }
+  cout << endl;
 }
 
 
-// Loops through all of the ships in the userFleet and prompts for placement
-void Game::ManualPlacement(){
-  for(int i = 0; i < 5; i++){
-      PromptPlacement(i);
+// Accepts every pending connection on the listener and greets it with the
+// game menu
+template<class V>
+void BasicGameServer<V>::Accept(int listener){
+  int fd;   // accepted connection
+  while((fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0){
+    int one = 1;
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if(numSessions >= options.maxSessions || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0){
+      close(fd);
+      continue;
+    }
+    // Responses are small and answered at once, so they are not held back
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if(fd >= (int)sessions.size()){
+      sessions.resize(fd + 1);
     }
+    sessions[fd].reset(new Session(fd));
+    numSessions++;
+    peakSessions = max(peakSessions, numSessions);
+    Session &s = *sessions[fd];     // session of the new connection
+    s.flow = Serve(s);
+    s.flow.Start();
+    Send(s);
+  }
 }
 
 
-// Prompts the user for placement coordinates and desired direction.
-// Checks if the placement is valid, then places the ship if it is. 
-// Reprompts if it isn't.
-void Game::PromptPlacement(int shipLoc){
-  SquareState tmpSS;                                // temporary SquareState variable to be used 
-                                                    // for comparison
-  pair<int, int> origin;                            // target coordinates to be returned
-  string input;                                     // string input from the user
-  int inX,                                          // integer conversion from the user's input
-      inY;                                          // integer conversion from the user's input
-  bool valid = false,                               // bool to ensure valid entry
-       isNum;                                       // boot to ensure that second half of input 
-                                                    // is a number
-  vector<pair<int,int> > shipVec;                   // container of coordinates of where the given 
-                                                    // ship will be placed
-  int shipSize = userFleet[shipLoc].getSize();    // size of the given ship
+// Reads what the player has sent, up to maxPending bytes of input, and plays
+// the session with each complete line.
+// Closes the session if the player hung up or sent a line too long to be 
+// anything the game asks for.
+template<class V>
+void BasicGameServer<V>::Receive(Session &s){
+  const size_t maxLine = 256;     // longest line accepted
+  char buffer[4096];              // bytes read by one recv
+  ssize_t n = 1;                  // bytes read, 0 once the player hung up
+  while(s.input.size() < maxPending && (n = recv(s.fd, buffer, sizeof(buffer), 0)) > 0){
+    s.input.append(buffer, n);
+  }
+  if(n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)){
+    Close(s);
+    return;
+  }
+  Feed(s);
+  if(s.input.size() > maxLine && s.input.find('\n') == string::npos){
+    Close(s);
+    return;
+  }
+  Send(s);
+}
 
-  while(!valid){
-    DisplayGrid(userShips, USER);
-    cout << "\nWhere would you like to place your " 
-         << userFleet[shipLoc].getName() 
-         << " (ex: C5)?";
-    cin.clear();
-    getline(cin, input);
-    //Bulletproof - checks to ensure input is of valid length
-    if(input.length() > 3){
-      cout << "\nInvalid entry. The correct format is format for entry is"
-           << " LetterNumber, with no decimals (ex: C5)." 
-           << endl;
+
+// Plays the session with the complete lines of its input, one at a time, 
+// until none is left or maxPending bytes of output wait to be sent.
+// Returns true if any line was played.
+template<class V>
+bool BasicGameServer<V>::Feed(Session &s){
+  size_t start = 0,     // start of the next line in input
+         end;           // end of that line
+  while(s.output.size() - s.sent < maxPending && (end = s.input.find('\n', start)) != string::npos){
+    string line = s.input.substr(start, end - start);   // line without its newline
+    if(!line.empty() && line.back() == '\r'){
+      line.pop_back();
     }
-    else{
-      //Bulletproof - check to ensure that second half of input is a number
-      isNum = true;
-      for(int i = 1; i < input.length(); i++){
-        if(!isdigit(input[i])){
-          isNum = false;
-        }
+    s.lines.Push(move(line));
+    start = end + 1;
+  }
+  s.input.erase(0, start);
+  return start > 0;
+}
+
+
+// Sends as much of the session's output as the socket takes, playing any 
+// lines held back once the output has drained below maxPending. While output
+// is left over the session waits for EPOLLOUT as well, and while maxPending 
+// bytes are left it stops waiting for EPOLLIN.
+template<class V>
+void BasicGameServer<V>::Send(Session &s){
+  do{
+    while(s.sent < s.output.size()){
+      ssize_t n = send(s.fd, s.output.data() + s.sent, s.output.size() - s.sent, MSG_NOSIGNAL);
+      if(n < 0 && errno == EINTR){
+        continue;
       }
-      // Bulletproof
-      if(!isalpha(input[0]) || !isNum){
-         cout << "\nInvalid entry. The correct format is format for entry is"
-              << " LetterNumber, with no decimals (ex: C5)." 
-              << endl;
+      if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+        break;
       }
-      else{
-        // Bulletproof - handles both upper and lowercase letters
-        // Conversions from ASCII chars to integers
-        if(!isupper(input[0])){
-          inX = (int)input[0] - 97;
-        }
-        else{
-          inX = (int)input[0] - 65;
-        }
-        inY = stoi(input.substr(1,input.length() - 1)) - 1; 
-        if(inX > 9 || inX < 0 || inY > 9 || inY < 0){
-          cout << "\nInvalid entry, those coordinates are off the grid!" 
-               << endl;
-        }
-        else{
-          tmpSS = userShips[inY][inX].getSquareState();
-          if(tmpSS != EMPTY){
-            cout << "\nInvalid entry, you have already placed a ship there!" 
-                 << endl;
-          }
-          else {
-            // Prompts for direction then fills a vector with the relevant coordinates
-            int dir = DirectionMenu(inY, inX, shipSize);
-            switch(dir){
-              case 1:
-              {
-                for(int i = inY; i < inY + shipSize; i++){
-                  shipVec.push_back(make_pair(i, inX));
-                }
-                valid = true;
-                break;
-              }
-              case 2:
-              {
-                for(int i = inX; i < inX + shipSize; i++){
-                  shipVec.push_back(make_pair(inY, i));
-                }
-                valid = true;
-                break;
-              }
-              case 3:
-              {
-                for(int i = inY; i > inY - shipSize; i--){
-                  shipVec.push_back(make_pair(i, inX));
-                }
-                valid = true;
-                break;
-              }
-              case 4:
-              {
-                for(int i = inX; i > inX - shipSize; i--){
-                  shipVec.push_back(make_pair(inY, i));
-                }
-                valid = true;
-                break;
-              }
-              case 99: break;
-            }
-          }
-        }
+      if(n < 0){
+        Close(s);
+        return;
       }
+      s.sent += n;
+    }
+    if(s.sent == s.output.size()){
+      s.output.clear();
+      s.sent = 0;
     }
+  } while(s.sent == 0 && Feed(s));
+  size_t pending = s.output.size() - s.sent;    // bytes waiting to be sent
+  uint32_t events = (pending < maxPending ? uint32_t(EPOLLIN) : 0)    // events to wait for
+                  | (pending > 0 ? uint32_t(EPOLLOUT) : 0);
+  if(events != s.events){
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = s.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, s.fd, &event);
+    s.events = events;
   }
-  cout << "PLACING";
-  // Places ship at relevant locations
-  PlaceShip(shipVec, USER);
-  userFleet[shipLoc].setCoords(shipVec);
-  LogShipPlace(shipLoc, USER);
 }
 
 
-// Menu for prompting for direction. Returns an int representing a direction.
-// 1 = right; 2 = down; 3 = left; 4 = up
-// returns 99 if user wishes to go back
-int Game::DirectionMenu(int x, int y, int shipSize){
-  int input,                // user input
-        dir;                // direction to be returned
-  bool validDir = false;    // bool to ensure valid direction
-  string err = "\n Cannot place a ship in that direction!";
-  while(!validDir){
-    cout << "\n___________________"
-         << "\n| SELECT DIRECTION \\" 
-         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
-         << "\n1. Right"
-         << "\n2. Down"
-         << "\n3. Left"
-         << "\n4. Up"
-         << "\n5. Re-enter coordinates" 
-         << endl;
-    cin >> input;
-    cin.clear();
-    cin.ignore( 256, '\n' );
-    // checks if given input is valid, sets dir equal to appropriate value
-    switch(input) {
-      case 1: 
-      { 
-        if(CheckRight(x, y, shipSize)){
-          dir = 1;
-          validDir = true;
-        }
-        else{
-          cout << err << endl;
-        }
+// Plays the session for as long as the player stays connected: offers the
+// menu, starts a game of the Gametype chosen with randomly placed fleets, 
+// and plays turns in the same order as Game::Play (the player's shots, then
+// the computer's, checking for a winner after each) until one side wins.
+template<class V>
+Task<> BasicGameServer<V>::Serve(Session &s){
+  while(true){
+    s.output += serverMenu;
+    string line = co_await s.lines.Line();    // Gametype chosen by the player
+    Gametype gt;
+    if(!ParseGametype(line, gt)){
+      s.output += "\nInvalid entry, please enter classic, multifire, cruise or hardcore.";
+      continue;
+    }
+    s.game = pool.Acquire(gt, nextSeed++);
+    BasicGame<V> &game = *s.game;   // game being played
+    game.setDisplay(&s.display);
+    game.ConstructFleets();
+    game.RandomPlacement(USER);
+    game.RandomPlacement(COMP);
+    gamesStarted++;
+    do{
+      co_await game.PlayerTurn(s.lines);
+      turnsPlayed++;
+      if(game.CheckWin(USER) || game.CheckWin(COMP)){
         break;
       }
-      case 2: 
-      { 
-        if(CheckDown(x, y, shipSize)){
-          dir = 2;
-          validDir = true;
-        }
-        else{
-          cout << err << endl;
-        }
-        break;
+      game.CompTurn();
+    } while(!game.CheckWin(COMP));
+    pool.Release(move(s.game));
+  }
+}
+
+
+// Closes the connection and frees the session. s is gone afterwards.
+template<class V>
+void BasicGameServer<V>::Close(Session &s){
+  int fd = s.fd;    // connection being closed
+  epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  if(s.game){
+    pool.Release(move(s.game));
+  }
+  numSessions--;
+  sessions[fd].reset();
+}
+
+
+// Runs the game server until it is interrupted.
+// Returns 1 if it could not listen.
+template<class V>
+int RunServer(const ServerOptions &options){
+  BasicGameServer<V> server(options);
+  if(!server.Open()){
+    return 1;
+  }
+  server.Run();
+  return 0;
+}
+
+
+// Opens the given number of connections to the game server at address (a 
+// TCP port on the loopback interface, or the path of a Unix socket) and 
+// plays games on all of them for the given time, firing at every square in 
+// random order. Reports the latency of every turn: the time from sending the
+// last target of a turn to receiving the whole of the next prompt, which 
+// covers both players' shots and drawing the grids.
+// Returns 1 if the server could not be reached or hung up.
+template<class V>
+int RunLoadTest(const ServerOptions &options){
+  const char *typeNames[] = {"classic", "multifire", "cruise", "hardcore"};
+  const int maxEvents = 256;                // events handled per wait
+  epoll_event events[maxEvents];
+  vector<LoadConnection> connections(options.connections);
+  vector<double> turnMicros;                // latency of every turn in microseconds
+  long games = 0,                           // games finished
+       prompts = 0;                         // other responses (more targets wanted, rejected input)
+  int failures = 0;                         // connections the server hung up
+  RandomGenerator rng(options.seed);
+  RaiseFileLimit();
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  for(int i = 0; i < options.connections; i++){
+    LoadConnection &c = connections[i];
+    int result;   // result of connect
+    if(options.unixPath.empty()){
+      sockaddr_in address = {};
+      address.sin_family = AF_INET;
+      address.sin_port = htons(options.port);
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      c.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      int one = 1;
+      setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      result = connect(c.fd, (sockaddr *)&address, sizeof(address));
+    }
+    else{
+      sockaddr_un address = {};
+      address.sun_family = AF_UNIX;
+      strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+      c.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      result = connect(c.fd, (sockaddr *)&address, sizeof(address));
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u32 = i;
+    if((result < 0 && errno != EINPROGRESS) || epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &event) < 0){
+      cerr << "Could not connect to the server: " << strerror(errno) << endl;
+      return 1;
+    }
+    for(int sq = 0; sq < V::Squares(); sq++){
+      c.order.push_back(sq);
+    }
+  }
+  auto start = chrono::steady_clock::now();
+  auto end = start + chrono::duration<double>(options.seconds);
+  while(chrono::steady_clock::now() < end){
+    int n = epoll_wait(epollFd, events, maxEvents, 100);
+    for(int e = 0; e < n; e++){
+      LoadConnection &c = connections[events[e].data.u32];
+      char buffer[8192];    // bytes read by one recv
+      ssize_t got;          // bytes read, 0 once the server hung up
+      while((got = recv(c.fd, buffer, sizeof(buffer), 0)) > 0){
+        c.input.append(buffer, got);
       }
-      case 3: 
-      { 
-        if(CheckLeft(x, y, shipSize)){
-          dir = 3;
-          validDir = true;
-        }
-        else{
-          cout << err << endl;
-        }
-        break;
+      if(got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)){
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        failures++;
+        continue;
       }
-      case 4: 
-      { 
-        if(CheckUp(x, y, shipSize)){
-          dir = 4;
-          validDir = true;
-        }
-        else{
-          cout << err << endl;
+      if(c.input.empty() || c.input.back() != '?'){
+        continue;     // the rest of the response is still on its way
+      }
+      auto now = chrono::steady_clock::now();
+      bool menu = c.input.find("Game type") != string::npos,          // the game is over
+           turn = menu || c.input.find("TARGETTING GRID") != string::npos;   // a turn was played
+      if(c.waiting && turn){
+        turnMicros.push_back(chrono::duration<double, micro>(now - c.sentAt).count());
+      }
+      else if(c.waiting){
+        prompts++;
+      }
+      string line;    // next line sent to the server
+      if(menu){
+        games += c.playing;
+        c.playing = true;
+        c.next = c.order.size();
+        line = typeNames[options.gameType];
+      }
+      else{
+        // Squares are fired at in a new random order each pass; squares that
+        // were SHOT_DOWN are only hit on a later pass
+        if(c.next == c.order.size()){
+          for(int i = c.order.size() - 1; i > 0; i--){
+            swap(c.order[i], c.order[rng.Below(i + 1)]);
+          }
+          c.next = 0;
         }
-        break;
+        int sq = c.order[c.next++];   // square fired at
+        line = char('A' + sq % V::Height()) + to_string(sq / V::Height() + 1);
       }
-      case 5: 
-      { 
-        dir = 99;
-        validDir = true;
-        break;
+      line += '\n';
+      c.input.clear();
+      c.sentAt = now;
+      c.waiting = !menu;    // the first screen of a game is not a turn
+      if(send(c.fd, line.data(), line.size(), MSG_NOSIGNAL) != (ssize_t)line.size()){
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        failures++;
       }
-      //Bulletproof - Does not accept inputs other than 1-5;
-      default: cout << "\nInvalid entry, please enter a number 1-5 (no decimals)." 
-                    << endl;
-        break;
     }
   }
-  return dir;
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  for(LoadConnection &c : connections){
+    close(c.fd);
+  }
+  close(epollFd);
+  sort(turnMicros.begin(), turnMicros.end());
+  auto percentile = [&](double q){
+    return turnMicros.empty() ? 0.0 : turnMicros[min(turnMicros.size() - 1, size_t(q * turnMicros.size()))];
+  };
+  cout << "\n___________________"
+       << "\n| LOAD TEST        \\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" << fixed << setprecision(2)
+       << "\nBoard:             " << VariantName<V>()
+       << "\nGame type:         " << GametypeName(options.gameType)
+       << "\nConnections:       " << options.connections
+       << "\nElapsed time:      " << seconds << " s"
+       << "\nGames finished:    " << games
+       << "\nTurns played:      " << turnMicros.size()
+       << "\nThroughput:        " << turnMicros.size() / seconds << " turns/sec"
+       << "\nOther prompts:     " << prompts
+       << "\nTurn latency:      p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+       << " us, max " << (turnMicros.empty() ? 0.0 : turnMicros.back()) << " us"
+       << "\nDisconnected:      " << failures << endl;
+  return failures > 0 ? 1 : 0;
 }
 
-//Checks to see if a ship of size 's' can fit vertically above point (x,y)
-bool Game::CheckUp(int x, int y, int s){
-  bool isEmpty = true;
-  if(y - (s - 1) < 0){
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(userShips[x][y - n].getSquareState() != EMPTY){
-        isEmpty = false;
-        break;
+
+/*
+  Below exists all functions used for the Screen class
+*/
+
+// Appends n right aligned in a field of the given width
+void Screen::AppendNumber(int n, int width){
+  char digits[12];              // n written out, at most 11 characters
+  int length = snprintf(digits, sizeof(digits), "%d", n);
+  if(length < width){
+    frame.append(width - length, ' ');
+  }
+  frame.append(digits, length);
+}
+
+
+// Appends text with a strike through every character
+// i.e. AppendStruck("CARRIER") appends C̶A̶R̶R̶I̶E̶R
+void Screen::AppendStruck(string_view text){
+  for(char ch : text){
+    frame.append("\u0336");
+    frame.push_back(ch);
+  }
+}
+
+
+// Sends the composed frame to display and starts a new frame.
+// The terminal no longer shows the frame Draw left at the top, so the next
+// frame drawn in diff mode is drawn whole.
+void Screen::Write(ostream &display){
+  PROFILE_SCOPE(PHASE_RENDER);
+  Send(display, frame);
+  frame.clear();
+  onScreen = false;
+}
+
+
+// Sends the composed frame to display as a full screen and starts a new frame.
+// Outside of diff mode this is the same as Write. In diff mode the first 
+// frame clears the terminal and is drawn from the top left corner; every 
+// later frame only sends the runs of cells that differ from the frame drawn
+// before it. Unchanged cells between two changed ones are sent along with 
+// them when that is shorter than moving the cursor. The terminal below the 
+// frame is cleared and the cursor left there for the text that follows.
+void Screen::Draw(ostream &display){
+  if(!diff){
+    Write(display);
+    return;
+  }
+  PROFILE_SCOPE(PHASE_RENDER);
+  const int maxGap = 6;     // most unchanged cells sent to join two runs of changed cells
+  int numLines;             // lines of the frame
+  // Appends the ANSI sequence moving the cursor to row and column, counted from 1
+  auto moveTo = [&](int row, int col){
+    char sequence[32];
+    out.append(sequence, snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", row, col));
+  };
+  SplitCells(frame, cells, lines);
+  numLines = lines.size() - 1;
+  out.clear();
+  if(!onScreen){
+    out.append("\x1b[H\x1b[2J");
+    out.append(frame);
+  }
+  else{
+    int drawnNumLines = drawnLines.size() - 1;    // lines of the frame drawn before
+    for(int l = 0; l < numLines; l++){
+      int first = lines[l],                                           // first cell of the line
+          count = lines[l + 1] - first - 1,                           // cells on the line
+          drawnFirst = l < drawnNumLines ? drawnLines[l] : 0,         // the same for the line
+          drawnCount = l < drawnNumLines ? drawnLines[l + 1] - drawnFirst - 1 : 0;   // drawn before
+      // Returns true if cell c of the line differs from the one drawn before
+      auto changed = [&](int c){
+        if(c >= drawnCount){
+          return true;
+        }
+        string_view now(frame.data() + cells[first + c], cells[first + c + 1] - cells[first + c]);
+        string_view before(drawn.data() + drawnCells[drawnFirst + c], 
+                           drawnCells[drawnFirst + c + 1] - drawnCells[drawnFirst + c]);
+        return now != before;
+      };
+      for(int c = 0; c < count; c++){
+        if(!changed(c)){
+          continue;
+        }
+        int end = c + 1;          // cell after the last changed cell of the run
+        for(int k = end; k < count && k - end <= maxGap; k++){
+          if(changed(k)){
+            end = k + 1;
+          }
+        }
+        moveTo(l + 1, c + 1);
+        out.append(frame, cells[first + c], cells[first + end] - cells[first + c]);
+        c = end - 1;
+      }
+      if(drawnCount > count){
+        moveTo(l + 1, count + 1);
+        out.append("\x1b[K");
       }
     }
+    moveTo(numLines + 1, 1);
   }
-  return isEmpty;
+  out.append("\x1b[J");
+  Send(display, out);
+  swap(frame, drawn);
+  swap(cells, drawnCells);
+  swap(lines, drawnLines);
+  frame.clear();
+  onScreen = true;
 }
 
-//Checks to see if a ship of size 's' can fit vertically below point (x,y)
-bool Game::CheckDown(int x, int y, int s){
-  bool isEmpty = true;
-  if(y + (s - 1) > 9){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(userShips[x][y + n].getSquareState() != EMPTY){
-        isEmpty = false;
-        break;
-      }
+
+// Finds where every cell of text starts, a cell being one column of the 
+// terminal: a character with any combining marks that follow it.
+// The cells of line l are cells[lines[l]] up to cells[lines[l + 1] - 1], 
+// which is where the line ends. lines holds one more entry than there are
+// lines.
+void Screen::SplitCells(const string &text, vector<int> &cells, vector<int> &lines){
+  cells.clear();
+  lines.clear();
+  lines.push_back(0);
+  for(size_t i = 0; i < text.size(); i++){
+    unsigned char byte = text[i];
+    bool combining = byte == 0xCC || (byte == 0xCD && i + 1 < text.size() 
+                                      && (unsigned char)text[i + 1] < 0xB0);  // U+0300 to U+036F
+    if(byte == '\n'){
+      cells.push_back(i);
+      lines.push_back(cells.size());
     }
+    else if((byte & 0xC0) != 0x80 && !(combining && (int)cells.size() > lines.back())){
+      cells.push_back(i);
+    }
+  }
+  if((int)cells.size() > lines.back()){
+    cells.push_back(text.size());
+    lines.push_back(cells.size());
   }
-  return isEmpty;
 }
 
-//Checks to see if a ship of size 's' can fit horizontally left of point (x,y)
-bool Game::CheckLeft(int x, int y, int s){
-  bool isEmpty = true;
-  if(x - (s - 1) < 0){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(userShips[x - n][y].getSquareState() != EMPTY){
-        isEmpty = false;
-        break;
-      }
+
+// Writes text to display. Text for the terminal bypasses the stream: 
+// whatever the stream holds is flushed and text follows in a single write().
+void Screen::Send(ostream &display, const string &text){
+  if(display.rdbuf() != cout.rdbuf()){
+    display.write(text.data(), text.size());
+    return;
+  }
+  display.flush();
+  size_t written = 0;     // bytes of text written so far
+  while(written < text.size()){
+    ssize_t n = write(STDOUT_FILENO, text.data() + written, text.size() - written);
+    if(n <= 0){
+      break;
     }
+    written += n;
   }
-  return isEmpty;
 }
 
-//Checks to see if a ship of size 's' can fit horizontally right of point (x,y)
-bool Game::CheckRight(int x, int y, int s){
-  bool isEmpty = true;
-  if(x + (s - 1) > 9){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(userShips[x + n][y].getSquareState() != EMPTY){
-        isEmpty = false;
-        break;
-      }
+
+#ifdef BATTLESHIP_PROFILE
+/*
+  Below exists all functions used for profiling, which are only compiled 
+  with -DBATTLESHIP_PROFILE.
+*/
+
+mutex ThreadProfile::lock;
+vector<ThreadProfile *> ThreadProfile::live;
+PhaseCounters ThreadProfile::retired[NUM_PHASES];
+uint64_t ThreadProfile::startTicks;
+chrono::steady_clock::time_point ThreadProfile::startTime;
+thread_local ProfileScope *ProfileScope::current = nullptr;
+
+
+// Counts the scope as a call of its phase and its time toward the scope 
+// it is nested in
+ProfileScope::~ProfileScope(){
+  uint64_t ticks = ThreadProfile::Now() - start;    // time spent in the scope
+  current = parent;
+  if(parent){
+    parent->childTicks += ticks;
+  }
+  ThreadProfile::Current().Add(phase, ticks, ticks - childTicks);
+}
+
+
+// Registers the profile of a newly started thread
+ThreadProfile::ThreadProfile(){
+  lock_guard<mutex> guard(lock);
+  live.push_back(this);
+}
+
+
+// Adds the counts of an exiting thread to the totals of finished threads
+ThreadProfile::~ThreadProfile(){
+  lock_guard<mutex> guard(lock);
+  for(int p = 0; p < NUM_PHASES; p++){
+    retired[p].calls += phases[p].calls;
+    retired[p].ticks += phases[p].ticks;
+    retired[p].selfTicks += phases[p].selfTicks;
+    retired[p].maxTicks = max(retired[p].maxTicks.load(), phases[p].maxTicks.load());
+    for(int b = 0; b < PhaseCounters::numBuckets; b++){
+      retired[p].buckets[b] += phases[p].buckets[b];
     }
   }
-  return isEmpty;
+  live.erase(find(live.begin(), live.end(), this));
 }
 
 
-// Checks if a given point (x,y) is too close to any of the grid borders.
-// Generates a random integer representing a valid direction 
-// (A direction that doesnt result in a ship being placed off the grid).
-// Returns this random integer.
-// 1 = right; 2 = down; 3 = left; 4 = up
-int Game::getRandomDirection(int x, int y, int s){
-  int rng = 0;
-  //left
-  if(x < s - 1){
-    // Grid location: left|top
-    if(y < s - 1){
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 3 || rng == 4);
-    }
-    // Grid location: left|bottom
-    else if(y > 10 - s){
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 2 || rng == 3);
+// Counts one call of phase that took ticks, selfTicks of them outside of
+// nested scopes
+void ThreadProfile::Add(ProfilePhase phase, uint64_t ticks, uint64_t selfTicks){
+  PhaseCounters &c = phases[phase];
+  int bucket = min(63 - __builtin_clzll(ticks | 1), PhaseCounters::numBuckets - 1);
+  c.calls.store(c.calls.load(memory_order_relaxed) + 1, memory_order_relaxed);
+  c.ticks.store(c.ticks.load(memory_order_relaxed) + ticks, memory_order_relaxed);
+  c.selfTicks.store(c.selfTicks.load(memory_order_relaxed) + selfTicks, memory_order_relaxed);
+  c.buckets[bucket].store(c.buckets[bucket].load(memory_order_relaxed) + 1, memory_order_relaxed);
+  if(ticks > c.maxTicks.load(memory_order_relaxed)){
+    c.maxTicks.store(ticks, memory_order_relaxed);
+  }
+}
+
+
+// Returns the profile of the calling thread
+ThreadProfile &ThreadProfile::Current(){
+  static thread_local ThreadProfile profile;
+  return profile;
+}
+
+
+// Returns the current tick count
+uint64_t ThreadProfile::Now(){
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+
+// Notes the time ticks are measured from and arranges for the summary to be
+// printed to stderr at exit and every time the process receives SIGUSR1.
+// SIGUSR1 is blocked in every thread and taken by a thread of its own with 
+// sigwait, so the summary is never printed from inside a signal handler.
+// Must be called before any other thread is started.
+void ThreadProfile::Start(){
+  startTicks = Now();
+  startTime = chrono::steady_clock::now();
+  sigset_t signals;     // the signals the printing thread waits for
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGUSR1);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  thread([signals](){
+    int signal;
+    while(sigwait(&signals, &signal) == 0){
+      Print(cerr);
     }
-    else{
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 3);
+  }).detach();
+  atexit([](){
+    Print(cerr);
+  });
+}
+
+
+// Prints the calls, total and self time of every phase summed over every
+// thread, followed by a histogram of how long the calls of each phase took.
+// Percentiles are read off the histogram, so they are only accurate to a 
+// power of two. The summary is formatted apart from out, whose format flags
+// are left alone, and written to it under lock in one piece, so summaries 
+// printed at the same time do not interleave.
+void ThreadProfile::Print(ostream &out){
+  const int numBuckets = PhaseCounters::numBuckets;
+  const char *names[NUM_PHASES] = {"game (other)", "placement", "player turn", "computer turn",
+                                   "AI evaluation", "hit resolution", "rendering", "logging",
+                                   "input wait"};
+  ostringstream text;                           // the summary, written to out at once
+  uint64_t calls[NUM_PHASES] = {},              // counters summed over every thread
+           ticks[NUM_PHASES] = {},
+           selfTicks[NUM_PHASES] = {},
+           maxTicks[NUM_PHASES] = {},
+           buckets[NUM_PHASES][numBuckets] = {},
+           allSelfTicks = 0;                    // time spent in any phase
+  double elapsed = chrono::duration<double, micro>(chrono::steady_clock::now() - startTime).count();
+  double ticksPerMicro = elapsed > 0 ? (Now() - startTicks) / elapsed : 1;
+  {
+    lock_guard<mutex> guard(lock);
+    vector<PhaseCounters *> profiles(1, retired);
+    for(ThreadProfile *profile : live){
+      profiles.push_back(profile->phases);
     }
+    for(PhaseCounters *phases : profiles){
+      for(int p = 0; p < NUM_PHASES; p++){
+        calls[p] += phases[p].calls.load(memory_order_relaxed);
+        ticks[p] += phases[p].ticks.load(memory_order_relaxed);
+        selfTicks[p] += phases[p].selfTicks.load(memory_order_relaxed);
+        maxTicks[p] = max(maxTicks[p], phases[p].maxTicks.load(memory_order_relaxed));
+        for(int b = 0; b < numBuckets; b++){
+          buckets[p][b] += phases[p].buckets[b].load(memory_order_relaxed);
+        }
+      }
+    }
+  }
+  for(int p = 0; p < NUM_PHASES; p++){
+    allSelfTicks += selfTicks[p];
   }
-  //right
-  else if(x > 10 - s){
-    // Grid location: right|top
-    if(y < s - 1){
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 1 || rng == 4);
+  // Returns the time in microseconds below which fraction of the calls of phase p took
+  auto percentile = [&](int p, double fraction){
+    uint64_t seen = 0;
+    for(int b = 0; b < numBuckets; b++){
+      seen += buckets[p][b];
+      if(seen >= fraction * calls[p]){
+        return min(double(2ULL << b), double(maxTicks[p])) / ticksPerMicro;
+      }
     }
-    // Grid location: right|bottom
-    else if(y > 10 - s){
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 1 || rng == 2);
+    return maxTicks[p] / ticksPerMicro;
+  };
+  text << "\n___________________"
+       << "\n| PROFILE          \\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" << fixed
+       << "\n" << left << setw(16) << "Phase" << right << setw(12) << "Calls" << setw(12) << "Total ms"
+       << setw(12) << "Self ms" << setw(8) << "Self %" << setw(11) << "Mean us" << setw(11) << "p50 us"
+       << setw(11) << "p90 us" << setw(11) << "p99 us" << setw(11) << "Max us" << endl;
+  for(int p = 0; p < NUM_PHASES; p++){
+    if(calls[p] == 0){
+      continue;
     }
-    else{
-      do{
-        rng = rand() % 3 + 1;
-      }while(rng == 1);
+    text << left << setw(16) << names[p] << right << setw(12) << calls[p] << setprecision(1)
+         << setw(12) << ticks[p] / ticksPerMicro / 1000 << setw(12) << selfTicks[p] / ticksPerMicro / 1000
+         << setw(8) << (allSelfTicks ? 100.0 * selfTicks[p] / allSelfTicks : 0.0) << setprecision(2)
+         << setw(11) << ticks[p] / ticksPerMicro / calls[p] << setw(11) << percentile(p, 0.5) 
+         << setw(11) << percentile(p, 0.9) << setw(11) << percentile(p, 0.99) 
+         << setw(11) << maxTicks[p] / ticksPerMicro << endl;
+  }
+  for(int p = 0; p < NUM_PHASES; p++){
+    uint64_t most = *max_element(buckets[p], buckets[p] + numBuckets);   // fullest bucket
+    if(calls[p] == 0){
+      continue;
+    }
+    text << "\n" << names[p] << " calls by duration (us):" << endl;
+    for(int b = 0; b < numBuckets; b++){
+      if(buckets[p][b] > 0){
+        text << setprecision(2) << setw(12) << double(1ULL << b) / ticksPerMicro << " - " << left 
+             << setw(12) << double(2ULL << b) / ticksPerMicro << right << " " << left << setw(40)
+             << string(max<uint64_t>(1, buckets[p][b] * 40 / most), '#') << right << " " 
+             << buckets[p][b] << endl;
+      }
     }
   }
-  // Grid location: top|middle
-  else if(y < s - 1){
-    do{
-      rng = rand() % 3 + 1;
-    }while(rng == 4);
+  lock_guard<mutex> guard(lock);
+  out << text.str() << flush;
+}
+#endif
+
+
+/*
+  Below exists all functions used for the GameLogger class
+*/
+
+// Opens (and truncates) the file at path and starts the writer thread.
+// Returns false if the file could not be opened.
+bool GameLogger::Open(const string &path){
+  Close();
+  file.open(path, ios::trunc);
+  if(!file.is_open()){
+    return false;
   }
-  // Grid location: bottom|middle
-  else if(y > 10 - s){
-    do{
-      rng = rand() % 3 + 1;
-    }while(rng == 2);
+  head.store(0, memory_order_relaxed);
+  tail.store(0, memory_order_relaxed);
+  pending = stopping = false;
+  writer = thread(&GameLogger::WriterLoop, this);
+  return true;
+}
+
+
+// Hands everything logged so far to the writer thread without waiting for
+// it to reach the file.
+void GameLogger::Flush(){
+  if(IsOpen()){
+    Wake();
   }
-  // Grid location:  middle|middle
-  else{
-    rng = rand() % 3 + 1;
+}
+
+
+// Writes everything logged so far, stops the writer thread and closes the 
+// file. Does nothing if the logger is not open.
+void GameLogger::Close(){
+  if(!IsOpen()){
+    return;
   }
-  return rng;
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+  file.close();
 }
 
 
-// Sets a ships coordinates equal to the given vector coords
-// Iterates through the given container of coordinates, coords and
-// changes the SquareState of that grid point to SHIP
-void Game::PlaceShip(vector<pair<int, int> > coords, Player p){
-  if(p == USER){
-    for(const pair<int, int> &coord: coords){
-      userShips[coord.first][coord.second].setSquareState(SHIP);
-    }
+// Asks the writer thread to drain the ring buffer
+void GameLogger::Wake(){
+  {
+    lock_guard<mutex> guard(lock);
+    pending = true;
   }
-  else{
-    for(const pair<int, int> &coord: coords){
-      compShips[coord.first][coord.second].setSquareState(SHIP);
+  wake.notify_one();
+}
+
+
+// Body of the writer thread: sleeps until woken, then drains the buffer to
+// the file. Exits after a final drain once Close is called.
+void GameLogger::WriterLoop(){
+  unique_lock<mutex> guard(lock);
+  while(true){
+    wake.wait(guard, [this]{return pending || stopping;});
+    bool stop = stopping;   // the last drain once stopping is set
+    pending = false;
+    guard.unlock();
+    Drain();
+    guard.lock();
+    if(stop){
+      return;
     }
   }
 }
 
 
-/*
-  SECTION 2: PLAY
-
-  The following code deals with the actual playing of the game. 
-  All functions in section 2 are executed while the user is playing.
-*/
+// Writes every byte between tail and head to the file; only called by the 
+// writer thread. The ring may wrap, in which case it is written in two parts.
+void GameLogger::Drain(){
+  size_t t = tail.load(memory_order_relaxed);
+  size_t h = head.load(memory_order_acquire);
+  if(h == t){
+    return;
+  }
+  size_t start = t % capacity;    // position of the first unwritten byte
+  size_t first = min(h - t, capacity - start);
+  file.write(ring + start, first);
+  file.write(ring, (h - t) - first);
+  file.flush();
+  tail.store(h, memory_order_release);
+}
 
 
-// Outlines what happens in the course of playing the game.
-// Each side takes a turn, with the user always going first.
-// After each side takes a turn, the game checks to see if either
-// has won.
-// After both turns are concluded, the game waits for the enter
-// key to be pressed, giving the player time to analyze what occurred.
-void Game::Play(){
-  gameState = PLAYING;
-  while(gameState == PLAYING){
-    //DisplayGrid(compTargeting); //uncomment for debugging
-    PlayerTurn();
-    if(CheckWin(USER) || CheckWin(COMP)) {
-      break;
+// Copies n bytes into the ring buffer, waking the writer when the buffered
+// text crosses the high-water mark and waiting for room when it is full.
+// Text logged while the logger is closed is discarded.
+streamsize GameLogger::xsputn(const char *s, streamsize n){
+  if(!IsOpen()){
+    return n;
+  }
+  size_t left = n;    // bytes still to be copied
+  while(left > 0){
+    size_t h = head.load(memory_order_relaxed);
+    size_t t = tail.load(memory_order_acquire);
+    size_t used = h - t;
+    if(used == capacity){
+      Wake();
+      this_thread::yield();
+      continue;
     }
-    else {
-      CompTurn();
-      CheckWin(COMP);
+    size_t chunk = min(min(left, capacity - used), capacity - h % capacity);
+    memcpy(ring + h % capacity, s, chunk);
+    head.store(h + chunk, memory_order_release);
+    if(used < highWater && used + chunk >= highWater){
+      Wake();
     }
-    cout << "\nPress Enter to Continue";
-    cin.ignore(std::numeric_limits<streamsize>::max(),'\n');
+    s += chunk;
+    left -= chunk;
   }
+  return n;
 }
 
 
-// Outlines everything that occurs during a players turn.
-// 1. Grids showing the locations of the player's ships and locations of the 
-//    player's shots are displayed.
-// 2. Checks what Gametype is selected. 
-//    If MULTIFIRE or HARDCORE have been chosen, a targetList is generated by 
-//    prompting the player a number of times equal to the number of ships they 
-//    have alive.
-//    If niether of those Gametypes are active, the user is prompted for only 
-//    one target.
-// 3. For each target prompted for, the target coordinates are checked to see
-//    if the resulting impact is a HIT, MISS, or if the missile was SHOT_DOWN.
-void Game::PlayerTurn(){
-  cout << "\n___________________"
-       << "\n| YOUR SHIPS       \\"
-       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" 
-       << endl;
-  DisplayGrid(userShips, USER);
-  cout << "\n___________________"
-       << "\n| TARGETTING GRID  \\"
-       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" 
-       << endl;
-  DisplayGrid(playerTargeting, COMP);
-  cout << "\n(Type ff to forfeit.)"<< endl;
-  if(gameType == MULTIFIRE || gameType == HARDCORE){
-    vector<pair<int, int> > targetList;     // container for up to several targetting solutions
-    int numShips = NumShipsAlive(USER);   // number of ships the player has AFLOAT
-    for(int i = 0; i < numShips; i++){
-      targetList.push_back(PromptFire());
-    }
-    for(int i = 0; i < numShips; i++){
-      CheckHit(targetList[i], USER);
-    }
+// Logs a single character
+GameLogger::int_type GameLogger::overflow(int_type c){
+  if(!traits_type::eq_int_type(c, traits_type::eof())){
+    char ch = traits_type::to_char_type(c);
+    xsputn(&ch, 1);
   }
-  else{
-    CheckHit(PromptFire(), USER);
+  return traits_type::not_eof(c);
+}
+
+
+// Formats the time and date again if the second has changed since they were
+// last formatted.
+void GameLogger::UpdateClock(){
+  time_t currentTime = time(nullptr);
+  if(currentTime == cachedSecond){
+    return;
   }
+  cachedSecond = currentTime;
+  tm local;         // broken down time; localtime_r as workers log at once
+  tm* timePtr = localtime_r(&currentTime, &local);
+  cachedTime =
+         to_string(timePtr->tm_hour) + ":"
+       + to_string(timePtr->tm_min) +":"
+       + to_string(timePtr->tm_sec);
+  cachedDate = 
+         to_string(timePtr->tm_mday) + "/"
+       + to_string((timePtr->tm_mon) + 1) + "/"
+       + to_string((timePtr->tm_year)+1900);
 }
 
 
-// Outlines everything that occurs during the computer's turn.
-// 1. Checks what Gametype is selected. 
-//    If MULTIFIRE or HARDCORE have been chosen, a targetList is generated by 
-//    evaluating the grid, compTargeting, a number of times equal to the number 
-//    of ships the computer has alive 
-//    If niether of those Gametypes are active, the grid is only evaluated once.
-// 2. For each target evaluated, the target coordinates are checked to see
-//    if the resulting impact is a HIT, MISS, or if the missile was SHOT_DOWN.
-void Game::CompTurn(){
-  pair<int, int> compTarget;              // firing solution to be generated by the AI's grid evaluation
-  if(gameType == MULTIFIRE || gameType == HARDCORE){
-    vector<pair<int, int> > targetList;   // container for up to several targetting solutions
-    int numShips = NumShipsAlive(COMP);   // number of ships the coputer has AFLOAT
-    for(int i = 0; i < numShips; i++){
-      compTarget = arty.EvaluateGrid(*this, arty.SmallestShipAlive(*this));
-      compTargeting[compTarget.second][compTarget.first].setSquareState(MISS);
-      targetList.push_back(compTarget);
-    }
-    for(int i = 0; i < numShips; i++){
-      CheckHit(targetList[i], COMP);
-    }
+// Gets the current time.
+const string &GameLogger::Time(){
+  UpdateClock();
+  return cachedTime;
+}
+
+
+// Gets the current date.
+const string &GameLogger::Date(){
+  UpdateClock();
+  return cachedDate;
+}
+
+
+// Returns the RecordFormat of games played with variant V
+template<class V>
+RecordFormat VariantFormat(){
+  RecordFormat f;
+  f.width = V::Width();
+  f.height = V::Height();
+  for(int i = 0; i < V::NumShips(); i++){
+    f.sizes.push_back(V::ShipSize(i));
   }
-  else{
-    compTarget = arty.EvaluateGrid(*this, arty.SmallestShipAlive(*this));
-    CheckHit(compTarget, COMP);
+  return f;
+}
+
+
+/*
+  Below exists all functions used for game record files
+*/
+
+// Appends value to out as a varint: 7 bits per byte, lowest bits first, with
+// the high bit set on every byte but the last.
+void PutVarint(vector<uint8_t> &out, uint64_t value){
+  while(value >= 0x80){
+    out.push_back(uint8_t(value) | 0x80);
+    value >>= 7;
   }
+  out.push_back(uint8_t(value));
 }
 
 
-// Loops through the given player/comp's fleet to see if every ship is SUNK
-// returns true if all ships are SUNK, false if at least one ship is AFLOAT
-bool Game::IsFleetDestroyed(Player p){
-  bool isDestroyed = true;
-  for(int i = 0; i < 5; i++){
-    if(p == USER){
-      if(userFleet[i].getShipState() == AFLOAT){
-        isDestroyed = false;
-      }
+// Reads a varint starting at p and moves p past it.
+// Returns false if the varint runs past end.
+bool GetVarint(const uint8_t *&p, const uint8_t *end, uint64_t &value){
+  value = 0;
+  for(int shift = 0; p < end && shift < 64; shift += 7){
+    uint8_t byte = *p++;
+    value |= uint64_t(byte & 0x7F) << shift;
+    if(byte < 0x80){
+      return true;
     }
-    else
-      if(compFleet[i].getShipState() == AFLOAT){
-        isDestroyed = false;
-      }
   }
-  return isDestroyed;
+  return false;
 }
 
-// Loops through the given Player p's fleet to see how many ships are alive
-// returns the number of ships alive in said fleet
-int Game::NumShipsAlive(Player p){
-  int numShips = 0;   // number of ships afloat; initialized to 0 for later incrementation
-  if(p == USER){
-    for(int i = 0; i < 5; i++){
-      if(userFleet[i].getShipState() == AFLOAT){
-        numShips++;
-      }
-    }
+
+// Returns the header a record file of the given format starts with:
+// "BSGR", the format version, the width, the height, the number of ships and
+// the size of each ship, one byte each.
+vector<uint8_t> EncodeFormat(const RecordFormat &f){
+  vector<uint8_t> header = {'B', 'S', 'G', 'R', 1, uint8_t(f.width), uint8_t(f.height), 
+                            uint8_t(f.sizes.size())};
+  for(int size : f.sizes){
+    header.push_back(uint8_t(size));
   }
-  else{
-    for(int i = 0; i < 5; i++){
-      if(compFleet[i].getShipState() == AFLOAT){
-        numShips++;
-      }
-    }
+  return header;
+}
+
+
+// Reads the header of a record file from the n bytes at p into f.
+// Returns the length of the header, or 0 if p does not start with a header.
+size_t DecodeFormat(const uint8_t *p, size_t n, RecordFormat &f){
+  if(n < 8 || memcmp(p, "BSGR", 4) != 0 || p[4] != 1 || n < size_t(8 + p[7])){
+    return 0;
   }
-  return numShips;
+  f.width = p[5];
+  f.height = p[6];
+  f.sizes.assign(p + 8, p + 8 + p[7]);
+  return 8 + p[7];
 }
 
 
-// Reduces a ships health by 1
-// Sets the ships state to SUNK if health is reduced to 0
-void Ship::Damage(){
-  health--;
-  if(health == 0){
-    shipState = SUNK;
+// Opens the record file at path for appending games of format f, writing the
+// header if the file is new. Returns false if the file cannot be opened or 
+// holds games of another format.
+bool GameRecordWriter::Open(const string &path, const RecordFormat &f){
+  Close();
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if(fd < 0){
+    return false;
+  }
+  format = f;
+  vector<uint8_t> header = EncodeFormat(f);   // header the file must start with
+  struct stat info;
+  if(fstat(fd, &info) == 0 && info.st_size == 0){
+    buffer = header;
+    return true;
   }
+  vector<uint8_t> existing(header.size());    // header found in the file
+  RecordFormat found;
+  if(pread(fd, existing.data(), existing.size(), 0) != ssize_t(existing.size())
+     || DecodeFormat(existing.data(), existing.size(), found) == 0 || !(found == f)){
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  return true;
 }
 
 
-// Prompts the user for targeting coordinates and returns those coordinates as a 
-// pair of integers. Used pair to allow for ease of returning two variables.
-pair<int, int> Game::PromptFire(){
-  SquareState tmpSS;        // temporary SquareState variable to be used for comparison
-  pair<int, int> target;    // target coordinates to be returned
-  string input;             // string input from the user
-  int inX,                  // integer conversion from the user's input
-      inY;                  // integer conversion from the user's input
-  bool valid = false,       // bool to ensure valid entry
-       isNum;               // boot to ensure that second half of input is a number
-  while(!valid){
-    cout << "\nWhere would you like to fire (ex: C5)?";
-    cin.clear();
-    getline(cin, input);
-    // Specification C3 - Secret Option
-    if(input == "~"){
-      cout << "\n___________________"
-           << "\n| COMPUTER'S SHIPS \\"
-           << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" 
-           << endl;
-      DisplayGrid(compShips, COMP);
-    }
-    // User selection to forfeit the game
-    else if(input == "ff" || input == "FF"){
-      //set to (99,99) to indicate escape sequence
-      target = make_pair(99, 99);
-      valid = true;
-    }
-    // User selection to force AI to forfeit
-    else if(input == "YOUSUNKMYBATTLESHIP"){
-      target = make_pair(999,999);
-      valid = true;
-    }
-    else{
-      //Bulletproof - checks to ensure input is of valid length
-      if(input.length() > 3){
-        cout << "\nInvalid entry. The correct format is format for entry is"
-             << " LetterNumber, with no decimals (ex: C5)." 
-             << endl;
-      }
-      else{
-        //Bulletproof - check to ensure that second half of input is a number
-        isNum = true;
-        for(int i = 1; i < input.length(); i++){
-          if(!isdigit(input[i])){
-            isNum = false;
-          }
-        }
-        // Specification B1 - Validate Input
-        if(!isalpha(input[0]) || !isNum){
-         cout << "\nInvalid entry. The correct format is format for entry is"
-              << " LetterNumber, with no decimals (ex: C5)." 
-              << endl;
-        }
-        else{
-          // Bulletproof - handles both upper and lowercase letters
-          // Conversions from ASCII chars to integers
-          if(!isupper(input[0])){
-            inX = (int)input[0] - 97;
-          }
-          else{
-            inX = (int)input[0] - 65;
-          }
-          inY = stoi(input.substr(1,input.length() - 1)) - 1; 
-          if(inX > 9 || inX < 0 || inY > 9 || inY < 0){
-            cout << "\nInvalid entry, those coordinates are off the grid!" 
-                 << endl;
-          }
-          else{
-            // Specification A1 - Adv Input Validation
-            tmpSS = playerTargeting[inY][inX].getSquareState();
-            if(tmpSS != EMPTY){
-              // Check for Gametypes CRUISE_MISSILES or HARDCORE. SHOT_DOWN can still be fired upon.
-              if(tmpSS != SHOT_DOWN){
-              cout << "\nInvalid entry, you have already fired on those coordinates!" 
-                   << endl;
-              }
-              else {
-              target = make_pair(inX, inY);
-              valid = true;
-              }
-            }
-            else {
-              target = make_pair(inX, inY);
-              valid = true;
-            }
-          }
-        }
-      }
+// Appends the encoded record of one game to the file
+void GameRecordWriter::Append(const vector<uint8_t> &record){
+  lock_guard<mutex> guard(lock);
+  buffer.insert(buffer.end(), record.begin(), record.end());
+  if(buffer.size() >= flushBytes){
+    WriteBuffer();
+  }
+}
+
+
+// Writes the buffered records to the file; the caller holds lock
+void GameRecordWriter::WriteBuffer(){
+  size_t written = 0;     // bytes of the buffer written so far
+  while(written < buffer.size()){
+    ssize_t n = write(fd, buffer.data() + written, buffer.size() - written);
+    if(n <= 0){
+      cerr << "Could not write game records" << endl;
+      break;
     }
+    written += n;
   }
-  return target;
+  buffer.clear();
 }
 
 
-// Checks to see if the given target coordinates result in a hit or miss. 
-// Changes the appropriate grids and ships to display the outcome of this check.
-void Game::CheckHit(pair<int, int> target, Player p){
-  SquareState tmpSS;            // temporary SquareState variable to be used for comparison
-  int tarRow = target.first;    
-  int tarCol = target.second;   // coordinates of the given target
-  LogFire(tarCol, tarRow, p);
-  if(tarRow == 99)
+// Writes any buffered records and closes the file
+void GameRecordWriter::Close(){
+  if(fd < 0){
+    return;
+  }
   {
-    Forfeit(USER);
+    lock_guard<mutex> guard(lock);
+    WriteBuffer();
   }
-  else if(tarRow == 999){
-    Forfeit(COMP);
+  close(fd);
+  fd = -1;
+}
+
+
+// Maps the record file at path into memory and reads its header.
+// Returns false if the file cannot be mapped or is not a record file.
+bool GameRecordReader::Open(const string &path){
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0){
+    return false;
   }
-  else{
-    if(p == USER){
-      tmpSS = compShips[tarCol][tarRow].getSquareState();
-      if(tmpSS == SHIP || tmpSS == SHOT_DOWN){
-        if(gameType == CRUISE_MISSILES || gameType == HARDCORE) {
-          if(ShootDownMissile()){
-            cout << "Your missile was SHOT DOWN!" 
-                 << endl;
-            playerTargeting[tarCol][tarRow].setSquareState(SHOT_DOWN);
-            LogShotDown();
-          }
-          else {
-            ShipHit(tarCol, tarRow, p);
-          }
-        }
-        else{
-          ShipHit(tarCol, tarRow, p);
-        }
-      }
-      else{
-        // Conversion from ints to identifiable grid coordinates (Will be used a lot)
-        cout << "\nYour shot at (" 
-             << char(tarRow + 65) << ", " 
-             << tarCol + 1 << ")"
-             << " was a MISS!" << endl;
-        playerTargeting[tarCol][tarRow].setSquareState(MISS);
-        LogMiss();
-      }
-    }
-    else{
-      cout << "\nComputer fired at (" 
-           << char(tarRow + 65) << ", " 
-           << tarCol + 1 << ")."
-           << endl;
-      tmpSS = userShips[tarCol][tarRow].getSquareState();
-      if(tmpSS == SHIP || tmpSS == SHOT_DOWN){
-        if(gameType == CRUISE_MISSILES || gameType == HARDCORE) {
-          if(ShootDownMissile()){
-            cout << "The missile was SHOT DOWN!" 
-                 << endl;
-            compTargeting[tarCol][tarRow].setSquareState(SHOT_DOWN);
-            userShips[tarCol][tarRow].setSquareState(SHOT_DOWN);
-            LogShotDown();
-          }
-          else {
-           ShipHit(tarCol, tarRow, p);
-          }
-        }
-        else{
-          ShipHit(tarCol, tarRow, p);
-        }
-      }
-      else{
-        cout << "It was a MISS!" << endl;
-        compTargeting[tarCol][tarRow].setSquareState(MISS);
-        userShips[tarCol][tarRow].setSquareState(MISS);
-        LogMiss();
-      }
+  struct stat info;
+  if(fstat(fd, &info) == 0 && info.st_size > 0){
+    void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map != MAP_FAILED){
+      data = static_cast<const uint8_t *>(map);
+      size = info.st_size;
+      madvise(map, size, MADV_SEQUENTIAL);
     }
   }
+  close(fd);
+  offset = data ? DecodeFormat(data, size, format) : 0;
+  if(offset == 0){
+    Close();
+    return false;
+  }
+  return true;
 }
 
 
-// Upon a ship being hit, prints to inform the user.
-// Also evaluates whether a ship was SUNK as a result from the hit.
-// Modifies respective grids to reflect these changes
-void Game::ShipHit(int tarCol, int tarRow, Player p){
-  int shipLoc = GetShip(make_pair(tarCol, tarRow), p);    // index location of ship
-  LogHit();
-  if(p == USER){
-    cout << "\nYour shot at (" 
-         << char(tarRow + 65) << ", " 
-         << tarCol + 1 << ")"
-         << " was a HIT!" << endl;
-    playerTargeting[tarCol][tarRow].setSquareState(HIT);
-    compFleet[shipLoc].Damage();
-    LogDamage(shipLoc, p);
-    if(compFleet[shipLoc].getShipState() == SUNK){
-      cout << "\nYOU SUNK THE ENEMY'S " 
-           << compFleet[shipLoc].getName() << "!" 
-           << endl;
-      SinkShip(shipLoc, p);
-      LogSink(shipLoc, p);
+// Reads the next game of the file into game.
+// Returns false at the end of the file or if the next record is damaged 
+// (such as the last record of a file whose writer was killed); AtEnd tells
+// the two apart.
+bool GameRecordReader::Next(RecordedGame &game){
+  const uint8_t *p = data + offset;   // position being read
+  const uint8_t *end = data + size;   // end of the file, then of the record
+  uint64_t length, value;
+  if(!GetVarint(p, end, length) || length > uint64_t(end - p)){
+    return false;
+  }
+  end = p + length;
+  if(!GetVarint(p, end, game.seed) || p == end){
+    return false;
+  }
+  game.gameType = Gametype(*p & 3);
+  game.winner = Player((*p >> 2) & 1);
+  game.forfeited = (*p >> 3) & 1;
+  game.forfeiter = Player((*p >> 4) & 1);
+  p++;
+  game.numShips = format.sizes.size();
+  game.placements = p;
+  for(int i = 0; i < 2 * game.numShips; i++){
+    if(!GetVarint(p, end, value)){
+      return false;
     }
   }
-  else{
-    cout << "It was a HIT!" << endl;
-    compTargeting[tarCol][tarRow].setSquareState(HIT);
-    userShips[tarCol][tarRow].setSquareState(HIT);
-    userFleet[shipLoc].Damage();
-    LogDamage(shipLoc, p);
-    if(userFleet[shipLoc].getShipState() == SUNK){
-      cout << "\nTHE ENEMY SUNK YOUR " 
-           << userFleet[shipLoc].getName() << "!" 
-           << endl;
-    SinkShip(shipLoc, p);
-    LogSink(shipLoc, p);
-    } 
+  game.shotBits = format.ShotBits();
+  game.numSquares = format.width * format.height;
+  if(!GetVarint(p, end, value) || (value * game.shotBits + 7) / 8 > uint64_t(end - p)){
+    return false;
   }
+  game.numShots = value;
+  game.shots = p;
+  game.end = end;
+  offset = end - data;
+  return true;
 }
 
 
-// Performs check to see if incoming missile was shot down (80% chance)
-bool Game::ShootDownMissile(){
-  bool shotDown = false;
-  int rng = rand() % 10 + 1;    // random number 1-10 generated to simulate chance
-  if(rng <= 8){
-    shotDown = true;
+// Unmaps the file
+void GameRecordReader::Close(){
+  if(data){
+    munmap(const_cast<uint8_t *>(data), size);
+  }
+  data = nullptr;
+  size = offset = 0;
+}
+
+
+// Decodes the placement of every ship: the user's fleet first, then the 
+// computer's. origin is the Bitboard index of the ship's first square, or -1
+// if the record places it outside the grid.
+void RecordedGame::Placements(int origin[], bool vertical[]) const {
+  const uint8_t *p = placements;    // position being read
+  uint64_t value;
+  for(int i = 0; i < 2 * numShips; i++){
+    GetVarint(p, shots, value);
+    origin[i] = (value >> 1) < uint64_t(numSquares) ? int(value >> 1) : -1;
+    vertical[i] = value & 1;
   }
-  return shotDown;
 }
 
 
+// Decodes shot i. A shot spans at most three bytes, which are read without
+// going past the end of the record.
+RecordedShot RecordedGame::Shot(int i) const {
+  static const SquareState results[4] = {MISS, HIT, SINK, SHOT_DOWN};
+  long bit = long(i) * shotBits;            // position of the shot's lowest bit
+  const uint8_t *p = shots + (bit >> 3);    // byte holding that bit
+  uint32_t word = 0;                        // bytes holding the shot
+  for(int k = 0; k < 3 && p + k < end; k++){
+    word |= uint32_t(p[k]) << (8 * k);
+  }
+  word = (word >> (bit & 7)) & ((1u << shotBits) - 1);
+  return RecordedShot{int(word >> 3), Player((word >> 2) & 1), results[word & 3]};
+}
+
 
-// Checks the given coords to see which ship is contained at that location. 
-// Returns the index of where the ship is located in its repective fleet vector.
-int Game::GetShip(pair<int, int> coords, Player p) {
-  int shipLoc = 99;                   // index location of ship. Initialized to 99 for debugging purposes
-  vector<pair<int, int> > shipVec;    // container of coordinates of where ship is located
-  // Loops through each ship, checking if any of its coordinates match the coordinates given
-  for (int i = 0; i < 5; i++) {
-    if(p == USER){
-      shipVec = compFleet[i].getCoords();
-    }
-    else{
-      shipVec = userFleet[i].getCoords();
+// Reads every game of the record file at path, decoding every placement 
+// and shot, and prints the number of games and shots of each kind along 
+// with how quickly they were read.
+// Returns 1 if the file cannot be read or ends in a damaged record.
+int PrintRecordStats(const string &path){
+  GameRecordReader reader;
+  if(!reader.Open(path)){
+    cerr << "Could not read " << path << " as a game record file" << endl;
+    return 1;
+  }
+  const RecordFormat &format = reader.getFormat();
+  long games = 0,             // games read
+       wins[2] = {0, 0},      // games won by each player
+       types[4] = {0, 0, 0, 0};   // games of each Gametype
+  uint64_t shots = 0,         // shots read
+           results[6] = {0, 0, 0, 0, 0, 0},   // shots with each result
+           badSquares = 0;    // placements and shots outside the grid
+  unique_ptr<int[]> origin(new int[2 * format.sizes.size()]);       // placements of the current game
+  unique_ptr<bool[]> vertical(new bool[2 * format.sizes.size()]);
+  RecordedGame game;
+  auto start = chrono::steady_clock::now();
+  while(reader.Next(game)){
+    games++;
+    wins[game.winner]++;
+    types[game.gameType]++;
+    game.Placements(origin.get(), vertical.get());
+    for(int i = 0; i < 2 * game.numShips; i++){
+      badSquares += origin[i] < 0;
     }
-    for (auto &n : shipVec) {
-      if(coords.first == n.first && coords.second == n.second){
-        shipLoc = i;
-      }
+    for(int i = 0; i < game.numShots; i++){
+      RecordedShot shot = game.Shot(i);
+      results[shot.result]++;
+      badSquares += shot.square >= format.width * format.height;
     }
+    shots += game.numShots;
+  }
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  struct stat info;
+  stat(path.c_str(), &info);
+  cout << "\n___________________"
+       << "\n| GAME RECORDS     \\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" << fixed << setprecision(2)
+       << "\nBoard:             " << format.width << "x" << format.height << ", ships";
+  for(int size : format.sizes){
+    cout << " " << size;
   }
-  return shipLoc;
+  cout << "\nGames:             " << games 
+       << " (" << types[CLASSIC] << " classic, " << types[MULTIFIRE] << " multifire, "
+       << types[CRUISE_MISSILES] << " cruise, " << types[HARDCORE] << " hardcore)"
+       << "\nPlayer wins:       " << wins[USER]
+       << "\nComputer wins:     " << wins[COMP]
+       << "\nShots:             " << shots << " (" << results[MISS] << " miss, " << results[HIT] 
+       << " hit, " << results[SINK] << " sink, " << results[SHOT_DOWN] << " shot down)"
+       << "\nFile size:         " << info.st_size << " bytes, " 
+       << (games ? double(info.st_size) / games : 0.0) << " per game"
+       << "\nRead time:         " << seconds << " s, " << shots / seconds / 1e6 << " million shots/sec" 
+       << endl;
+  if(badSquares > 0){
+    cerr << badSquares << " placements or shots lie outside the grid" << endl;
+    return 1;
+  }
+  if(!reader.AtEnd()){
+    cerr << path << " ends in a damaged record" << endl;
+    return 1;
+  }
+  return 0;
 }
 
 
-//Displays the given grid
-/* EX:
-          1   2   3   4   5   6   7   8   9  10
-      -----------------------------------------
-    A |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    B |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    C |   |   |   |   |   |   | O |   |   |   |
-      -----------------------------------------
-    D |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    E |   |   |   |   | X |   |   |   |   |   |
-      -----------------------------------------
-    F |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    G |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    H |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    I |   |   |   |   |   |   |   |   |   |   |
-      -----------------------------------------
-    J |   |   |   |   |   |   | O |   |   |   |
-      -----------------------------------------
-*/
-void Game::DisplayGrid(Square grid[10][10], Player p){
-  string line = "  -----------------------------------------";
-  cout << "\n    1   2   3   4   5   6   7   8   9  10" << endl;
-  cout << line << endl;
-  for (int row = 0; row < 10; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (col == 0){
-        switch(row){
-        case 0: cout<< "A ";
-          break;
-        case 1: cout<< "B ";
-          break;
-        case 2: cout<< "C ";
-          break;
-        case 3: cout<< "D ";
-          break;
-        case 4: cout<< "E ";
-          break;
-        case 5: cout<< "F ";
-          break;
-        case 6: cout<< "G ";
-          break;
-        case 7: cout<< "H ";
-          break;
-        case 8: cout<< "I ";
-          break;
-        case 9: cout<< "J ";
-          break;
+// Replays every game of the record file at path on numThreads threads and 
+// reports how many games played out as recorded, how many were forfeited and
+// the first game (in file order) that diverged from its record.
+// Returns 1 if any game diverged or the file could not be read to the end.
+template<class V>
+int RunReplay(const string &path, int numThreads){
+  const int batchSize = 1024;     // games a worker takes from the file at a time
+  GameRecordReader reader;
+  if(!reader.Open(path)){
+    cerr << "Could not read " << path << " as a game record file" << endl;
+    return 1;
+  }
+  if(!(reader.getFormat() == VariantFormat<V>())){
+    cerr << path << " was not recorded with this board and fleet" << endl;
+    return 1;
+  }
+  mutex lock;                     // guards reader, the counts and the first divergence
+  long nextGame = 0,              // index of the next game to be read
+       games = 0,                 // games replayed
+       forfeits = 0,              // games that ended without a fleet being destroyed
+       divergences = 0,           // games that did not play out as recorded
+       firstIndex = -1;           // index of the first game that diverged
+  uint64_t firstSeed = 0;         // seed of that game
+  string firstDivergence;         // description of how it diverged
+  BasicGamePool<V> pool(numThreads);    // one game for each worker
+  auto worker = [&](){
+    vector<RecordedGame> batch(batchSize);
+    unique_ptr<BasicGame<V> > game = pool.Acquire(CLASSIC, 0);    // game every record is replayed on
+    while(true){
+      long first;                 // index of the first game of the batch
+      int n = 0;                  // games in the batch
+      {
+        lock_guard<mutex> guard(lock);
+        first = nextGame;
+        while(n < batchSize && reader.Next(batch[n])){
+          n++;
         }
-        cout << "|";
+        nextGame += n;
       }
-      grid[col][row].Print();
-      if (col < 10) {
-        cout << "|";
+      if(n == 0){
+        pool.Release(move(game));
+        return;
       }
-    }
-    // Displays the status of the user's ships after each grid line
-    if(p == USER){
-    switch(row){
-        case 0: 
-          PrintShipP1(0);
-          break;
-        case 1: 
-          PrintShipP2(0);
-          break;
-        case 2: 
-          PrintShipP1(1);
-          break;
-        case 3: 
-          PrintShipP2(1);
-          break;
-        case 4: 
-          PrintShipP1(2);
-          break;
-        case 5: 
-          PrintShipP2(2);
-          break;
-        case 6: 
-          PrintShipP1(3);
-          break;
-        case 7: 
-          PrintShipP2(3);
-          break;
-        case 8: 
-          PrintShipP1(4);
-          break;
-        case 9: 
-          PrintShipP2(4);
-          break;
+      long localForfeits = 0, localDivergences = 0;
+      for(int i = 0; i < n; i++){
+        game->Reset(batch[i].gameType, batch[i].seed);
+        string divergence;
+        if(!game->Replay(batch[i], divergence)){
+          localDivergences++;
+          lock_guard<mutex> guard(lock);
+          if(firstIndex < 0 || first + i < firstIndex){
+            firstIndex = first + i;
+            firstSeed = batch[i].seed;
+            firstDivergence = divergence;
+          }
+        }
+        else if(game->getGamestate() == PLAYING){
+          localForfeits++;
         }
-    }
-    else{
-      cout << "\n";
-      if (row < 10) {
-        cout << line << endl;
       }
+      lock_guard<mutex> guard(lock);
+      games += n;
+      forfeits += localForfeits;
+      divergences += localDivergences;
     }
+  };
+  auto start = chrono::steady_clock::now();
+  vector<thread> workers;         // worker threads
+  for(int i = 1; i < numThreads; i++){
+    workers.push_back(thread(worker));
   }
-}
-
-
-// PrintShip is divided into two parts. P1 prints the name of the ship as well as 
-// the top line of the squares that represent the ship and a line on the grid
-// ex print:
-//
-// DESTROYER
-//  ---------
-void Game::PrintShipP1(int shipLoc){
-  cout << "          ";
-  string shipName = userFleet[shipLoc].getName();   // name of the ship to be printed
-  if(userFleet[shipLoc].getShipState() == SUNK){
-    cout << StrikeName(shipName);
+  worker();
+  for(thread &t : workers){
+    t.join();
   }
-  else{
-    cout << shipName;
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  cout << "\n___________________"
+       << "\n| REPLAY           \\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" << fixed << setprecision(2)
+       << "\nBoard:             " << VariantName<V>()
+       << "\nGames replayed:    " << games
+       << "\nForfeited:         " << forfeits
+       << "\nDiverged:          " << divergences
+       << "\nElapsed time:      " << seconds << " s"
+       << "\nThroughput:        " << games / seconds * 60 / 1e6 << " million games/min" << endl;
+  if(firstIndex >= 0){
+    cout << "First divergence:  game " << firstIndex + 1 << " (seed " << firstSeed << "): " 
+         << firstDivergence << endl;
   }
-  cout << "\n  -----------------------------------------" 
-       << "            ";
-  for(int n = 0; n < userFleet[shipLoc].getSize(); n++){
-    cout << "----";
+  if(!reader.AtEnd()){
+    cerr << path << " ends in a damaged record" << endl;
+    return 1;
   }
-  cout << "-" << endl;
+  return divergences > 0 ? 1 : 0;
 }
 
 
-// P2 of PrintShip prints the bottom parts of the squares and a line on the grid. 
-// The squares are filled X's, representing how damaged a ship is. 
-// Blank squares represent health points (ie. 5 blank squares = 5 health).
-// X's that have been struck are indicative of a SUNK ship
-// ex print:
-//
-//    | X |   |
-//    ---------
-void Game::PrintShipP2(int shipLoc){
-  cout << "            ";
-  int shipSize = userFleet[shipLoc].getSize();        // size of the given ship
-  int shipHealth = userFleet[shipLoc].getHealth();    // health of the given ship
-  for(int i = 0; i < shipSize; i++){
-    cout << "|";
-    if(shipHealth == 0){
-      cout << StrikeName(" X ");
+// Prints the throughput, win rate and distribution of shots needed to win
+// for a batch of simulated games.
+template<class V>
+void PrintSimulationReport(Gametype gt, const SimulationOptions &options, 
+                           const SimulationStats &stats){
+  long seen = 0;                // games counted so far while walking the distribution
+  int median = 0,               // shots to win at the 50th percentile
+      p90 = 0,                  // shots to win at the 90th percentile
+      fewest = -1,              // fewest shots any winner needed
+      most = 0;                 // most shots any winner needed
+  for(int n = 0; n < (int)stats.shotsToWin.size(); n++){
+    if(stats.shotsToWin[n] == 0){
+      continue;
     }
-    else if(i < shipSize - shipHealth){
-      cout << " X ";
+    if(fewest < 0){
+      fewest = n;
     }
-    else{
-      cout << "   ";
+    most = n;
+    seen += stats.shotsToWin[n];
+    if(median == 0 && seen * 2 >= stats.games){
+      median = n;
+    }
+    if(p90 == 0 && seen * 10 >= stats.games * 9){
+      p90 = n;
     }
   }
-  cout << "|\n  -----------------------------------------" 
-       << "            ";
-  for(int n = 0; n < shipSize; n++){
-    cout << "----";
+  cout << "\n___________________"
+       << "\n| " << left << setw(17) << GametypeName(gt) << "\\"
+       << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯" << right << fixed << setprecision(2)
+       << "\nBoard:             " << VariantName<V>()
+       << "\nPlayer AI:         " << options.userAI
+       << "\nComputer AI:       " << options.compAI
+       << "\nGames played:      " << stats.games
+       << "\nElapsed time:      " << stats.seconds << " s"
+       << "\nThroughput:        " << stats.games / stats.seconds << " games/sec"
+       << "\nPlayer AI wins:    " << stats.userWins 
+       << " (" << 100.0 * stats.userWins / stats.games << "%)"
+       << "\nComputer wins:     " << stats.compWins 
+       << " (" << 100.0 * stats.compWins / stats.games << "%)"
+       << "\nRandom draws:      " << (double)stats.randomDraws / stats.games << " per game, " 
+       << RandomCost() * stats.randomDraws / stats.games << " ns per game"
+       << "\nFirst seed:        " << stats.seed
+       << "\nShots to win:      mean " << (double)stats.totalShots / stats.games
+       << ", min " << fewest << ", median " << median 
+       << ", p90 " << p90 << ", max " << most
+       << "\n\nShots to win   Games" << endl;
+  // Distribution in buckets of 5 shots
+  for(int n = 0; n <= most; n += 5){
+    long games = 0;   // games won within this bucket
+    for(int i = n; i < n + 5 && i < (int)stats.shotsToWin.size(); i++){
+      games += stats.shotsToWin[i];
+    }
+    if(games > 0){
+      cout << setw(5) << n << "-" << left << setw(8) << n + 4 << right 
+           << games << endl;
+    }
   }
-  cout << "-" << endl;
 }
 
 
-// Loops through a ships coordinate locations, setting the SquareState
-// of each relevant grid square to SINK.
-void Game::SinkShip(int shipLoc, Player p){
-  int x,y;                            // variables used to contain coordinates;
-                                      // solely used to enhance readability.
-  vector<pair<int, int> > shipVec;    // container of ships coordinates
-  if(p == USER){
-    shipVec = compFleet[shipLoc].getCoords();
-    for (auto &i : shipVec) {
-      x = i.first;
-      y = i.second;
-      playerTargeting[x][y].setSquareState(SINK);
-    }
+// Creates the targeting strategy with the given name: "heuristic" for 
+// AIOpponent or "montecarlo" for MonteCarloAI limited to the given samples
+// and microseconds per shot.
+// Returns nullptr if name does not name a strategy.
+template<class V>
+unique_ptr<BasicTargetingStrategy<V> > NewStrategy(const string &name, int samples, int budgetMicros){
+  if(name == "heuristic"){
+    return unique_ptr<BasicTargetingStrategy<V> >(new BasicAIOpponent<V>());
   }
-  else{
-    shipVec = userFleet[shipLoc].getCoords();
-    for (auto &i : shipVec) {
-      x = i.first;
-      y = i.second;
-      compTargeting[x][y].setSquareState(SINK);
-      userShips[x][y].setSquareState(SINK);
-    }
+  if(name == "montecarlo"){
+    return unique_ptr<BasicTargetingStrategy<V> >(new BasicMonteCarloAI<V>(samples, budgetMicros));
   }
+  return nullptr;
 }
 
 
-// Checks to see if either player has won the game
-// Returns true if Player 'p' won; false if not.
-bool Game::CheckWin(Player p){
-  bool win = false;   //bool to be returned
-  if(p == USER){
-    if(IsFleetDestroyed(COMP)){
-      gameState = USERWON;
-      LogWin(USER);
-      cout << "\nYOU HAVE DESTROYED ALL OF THE ENEMY'S SHIPS!"
-           << "\nYOU WIN!" << endl;
-      win = true;
-    }
+// Converts a Gametype name given on the command line to a Gametype.
+// Returns false if str does not name a Gametype.
+bool ParseGametype(const string &str, Gametype &gt){
+  string name;    // lowercase copy of str
+  for(auto ch : str){
+    name.push_back(tolower(ch));
   }
-  else {
-    if(IsFleetDestroyed(USER)){
-      gameState = USERWON;
-      LogWin(COMP);
-      cout << "\nALL FRIENDLY SHIPS HAVE BEEN DESTROYED!"
-           << "\nTHE COMPUTER WINS!" << endl;
-      win = true;
-    }
+  if(name == "classic"){
+    gt = CLASSIC;
   }
-  return win;
+  else if(name == "multifire"){
+    gt = MULTIFIRE;
+  }
+  else if(name == "cruise" || name == "cruise_missiles"){
+    gt = CRUISE_MISSILES;
+  }
+  else if(name == "hardcore"){
+    gt = HARDCORE;
+  }
+  else{
+    return false;
+  }
+  return true;
 }
 
 
-//Sinks all Player 'p's ships in order to end the current game
-void Game::Forfeit(Player p){
-  if(p == USER) {
-    for(int i = 0; i < 5; i++){
-      userFleet[i].setShipState(SUNK);
-    }
-  }
-  else {
-    for(int i = 0; i < 5; i++){
-      compFleet[i].setShipState(SUNK);
-    }
+// Returns the name of the given Gametype
+const char *GametypeName(Gametype gt){
+  switch(gt){
+    case CLASSIC: return "CLASSIC";
+    case MULTIFIRE: return "MULTIFIRE";
+    case CRUISE_MISSILES: return "CRUISE MISSILES";
+    case HARDCORE: return "HARDCORE";
   }
+  return "";
 }
 
 
-// Menu displayed once a game has concluded.
-// Prompts the user if they would like to play again
-// Returns true if yes, false if no
-bool Game::NewGameMenu(){
-  bool playAgain;             // bool to be returned
-  bool choiceMade = false;    // bool to ensure valid input
-  int input;                  // input from user
+// Returns the name of the result of a shot that left its target in state s
+const char *ResultName(SquareState s){
+  switch(s){
+    case MISS: return "MISS";
+    case HIT: return "HIT";
+    case SINK: return "SINK";
+    case SHOT_DOWN: return "SHOT DOWN";
+    default: return "NO SHOT";
+  }
+}
 
-  while(!choiceMade){
-    cout << "\n___________________"
-         << "\n| PLAY AGAIN?      \\"
-         << "\n¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯¯"
-         << "\n1. Yes"
-         << "\n2. No"
-         << endl;
-    cin >> input;
-    cin.clear();
-    cin.ignore( 256, '\n' );
-    switch(input) {
-      case 1: 
-      { 
-        playAgain = true;
-        choiceMade = true;
-        break;
-      }
-      case 2: 
-      { 
-        playAgain = false;
-        choiceMade = true;
-        cout << "Goodbye!" << endl;
-        LogExit();
-        break;
+
+// Statistical test of Game::RandomPlacement.
+// Places numFleets computer fleets, fleet n in a game seeded with seed + n, and 
+// checks that
+// * every fleet is legal: every ship on the grid, no ship overlapping another
+// * the first ship, placed on an empty grid, is spread uniformly over all of 
+//   its placements (chi-square test)
+// * every ship is drawn uniformly from the placements left open by the ships 
+//   placed before it. The rank of the chosen placement among the open ones is
+//   sorted into 10 bins, each expected to hold its share of the ranks
+//   (chi-square test)
+// Each chi-square test fails when its p-value falls below 0.001.
+// Returns true if every check passed.
+template<class V>
+bool RunPlacementTest(long numFleets, uint64_t seed){
+  const ShipPlacementTable<V> &table = PlacementTables<V>::ship;
+  const int numBins = 10;                     // bins the ranks are sorted into
+  const int firstSize = V::ShipSize(0);       // size of the first ship placed
+  int fleetSquares = 0;                       // squares covered by a whole fleet
+  for(int i = 0; i < V::NumShips(); i++){
+    fleetSquares += V::ShipSize(i);
+  }
+  int firstBegin = table.first[firstSize],
+      numFirst = table.first[firstSize + 1] - firstBegin;
+  vector<long> firstCounts(numFirst, 0);      // times each first ship placement was drawn
+  vector<double> rankExpected(numBins, 0),    // expected ranks in each bin
+                 rankCounts(numBins, 0);      // ranks drawn in each bin
+  long illegal = 0,                           // fleets with overlapping or missing squares
+       ships = 0,                             // ships placed
+       legalTotal = 0;                        // sum of the placements open to each ship
+  short legal[ShipPlacementTable<V>::numPlacements];
+  auto start = chrono::steady_clock::now();
+  for(long n = 0; n < numFleets; n++){
+    BasicGame<V> game(CLASSIC, false, seed + n);
+    game.ConstructFleets();
+    game.RandomPlacement(COMP);
+    BasicBitboard<V> occupied;                // squares of the ships placed so far
+    for(const BasicShip<V> &ship : game.getFleet(COMP)){
+      int numLegal = LegalPlacements<V>(occupied, ship.getSize(), legal);
+      int rank = -1;                          // position of the ship among the open placements
+      for(int r = 0; r < numLegal; r++){
+        if(table.masks[legal[r]] == ship.getMask()){
+          rank = r;
+        }
       }
-      //Bulletproof - Does not accept inputs other than 1 or 2
-      default: cout << "\nInvalid entry, please enter either 1 or 2." 
-                    << endl;
+      if(rank < 0){
+        illegal++;
         break;
+      }
+      if(occupied.Count() == 0){
+        firstCounts[legal[rank] - firstBegin]++;
+      }
+      for(int b = 0; b < numBins; b++){
+        // ranks r with r * numBins / numLegal == b
+        int ranksInBin = ((b + 1) * numLegal + numBins - 1) / numBins - (b * numLegal + numBins - 1) / numBins;
+        rankExpected[b] += double(ranksInBin) / numLegal;
+      }
+      rankCounts[rank * numBins / numLegal]++;
+      occupied |= ship.getMask();
+      ships++;
+      legalTotal += numLegal;
     }
+    illegal += occupied.Count() != fleetSquares;
   }
-  return playAgain;
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  double firstChi = 0,                        // chi-square of the first ship's placements
+         rankChi = 0;                         // chi-square of the ranks
+  double firstExpected = double(numFleets) / numFirst;
+  for(long count : firstCounts){
+    firstChi += (count - firstExpected) * (count - firstExpected) / firstExpected;
+  }
+  for(int b = 0; b < numBins; b++){
+    rankChi += (rankCounts[b] - rankExpected[b]) * (rankCounts[b] - rankExpected[b]) / rankExpected[b];
+  }
+  double firstP = ChiSquareP(firstChi, numFirst - 1),
+         rankP = ChiSquareP(rankChi, numBins - 1);
+  bool passed = illegal == 0 && firstP >= 0.001 && rankP >= 0.001;
+  cout << fixed << setprecision(2)
+       << "Placement test:    " << numFleets << " fleets from seed " << seed << '\n'
+       << "Board:             " << VariantName<V>() << '\n'
+       << "Throughput:        " << numFleets / seconds << " fleets/sec\n"
+       << "Open placements:   " << double(legalTotal) / max(ships, 1L) << " per ship on average\n"
+       << "Illegal fleets:    " << illegal << '\n'
+       << setprecision(4)
+       << "First ship:        chi-square " << firstChi << " (" << numFirst - 1 << " dof), p = " << firstP << '\n'
+       << "Open ranks:        chi-square " << rankChi << " (" << numBins - 1 << " dof), p = " << rankP << '\n'
+       << (passed ? "PASSED" : "FAILED") << endl;
+  return passed;
 }
 
 
-/*
-  SECTION 3:LOG
+// Returns the probability of a chi-square statistic of at least chiSquare 
+// with dof degrees of freedom, using the Wilson-Hilferty normal approximation
+double ChiSquareP(double chiSquare, int dof){
+  double v = 2.0 / (9.0 * dof);
+  double z = (cbrt(chiSquare / dof) - (1 - v)) / sqrt(v);
+  return 0.5 * erfc(z / sqrt(2.0));
+}
 
-  The following functions all deal with writing to the file, log.txt
-*/
 
-// Writes to log.txt whenever a new game is started.
-void Game::LogStart(){
-  file << "BATTLESHIP \n--------------------------- \nNew game started on " 
-       << GetDate() << " at " << GetTime() << "." 
-       << endl;
+// Sets the grid size to w columns by h rows and the fleet to ships of the
+// given sizes, then builds the placement tables.
+// Ships are named after their size; repeated sizes are numbered.
+// Returns false if the grid or fleet is not supported: the grid must be 5x5 
+// to 26x26 and hold 1 to 10 ships of size 2 to 8 that fit on the grid and 
+// cover at most half of it.
+bool RuntimeVariant::Configure(int w, int h, const vector<int> &fleet){
+  const char *classNames[maxShipSize + 1] = {"", "", "DESTROYER", "CRUISER", "BATTLESHIP", 
+                                             "CARRIER", "DREADNOUGHT", "DREADNOUGHT", "DREADNOUGHT"};
+  int fleetSquares = 0;   // squares covered by the whole fleet
+  if(w < 5 || w > maxWidth || h < 5 || h > maxHeight || fleet.empty() || (int)fleet.size() > maxShips){
+    return false;
+  }
+  for(int size : fleet){
+    if(size < 2 || size > maxShipSize || size > w || size > h){
+      return false;
+    }
+    fleetSquares += size;
+  }
+  if(2 * fleetSquares > w * h){
+    return false;
+  }
+  width = w;
+  height = h;
+  numShips = fleet.size();
+  for(int i = 0; i < numShips; i++){
+    int same = count(fleet.begin(), fleet.begin() + i, fleet[i]);   // earlier ships of this size
+    sizes[i] = fleet[i];
+    names[i] = classNames[fleet[i]] + (same > 0 ? " " + to_string(same + 1) : "");
+  }
+  PlacementTables<RuntimeVariant>::Build();
+  return true;
 }
 
-// Writes to log.txt what Gametype was selected.
-void Game::LogGameType(){
-  file << "Game Type ";
-  switch(gameType){
-    case CLASSIC: file << "CLASSIC";
-      break;
-    case MULTIFIRE: file << "MULTIFIRE";
-      break;
-    case CRUISE_MISSILES: file << "CRUISE MISSILES";
-      break;
-    case HARDCORE: file << "HARDCORE";
-      break;
+
+// Describes the grid size and fleet of variant V, i.e. "10x10, ships 5 4 3 3 2"
+template<class V>
+string VariantName(){
+  string name = to_string(V::Width()) + "x" + to_string(V::Height()) + ", ships";
+  for(int i = 0; i < V::NumShips(); i++){
+    name += " " + to_string(V::ShipSize(i));
   }
-  file << " was selected." << endl;
+  return name;
 }
 
-// Writes to log.txt whenever the program is exited.
-void Game::LogExit(){
-  file << "Game exited on " << GetDate() << " at " << GetTime() << "." << endl;
-  file.close();
-}
 
-//Writes to log.txt when and where a ship was placed on a grid
-void Game::LogShipPlace(int shipLoc, Player p){
-  vector<pair<int, int> > shipVec;    // container of ships coordinates
-  int shipSize;                       // size of given ship
-  file << "\n" << GetTime();
-  if(p == USER){
-    shipSize = userFleet[shipLoc].getSize();
-    shipVec = userFleet[shipLoc].getCoords();
-    file << " Player's " << userFleet[shipLoc].getName();
-  }
-  else{
-    shipSize = compFleet[shipLoc].getSize();
-    shipVec = compFleet[shipLoc].getCoords();
-    file << " Computer's " << compFleet[shipLoc].getName();
-  }
-  file << " placed at the following coordinates: " 
-       << endl;
-  for(int i = 0; i < shipSize; i++){
-    file << "(" << char(shipVec[i].second + 65) << ", " 
-         << shipVec[i].first + 1 << ")" 
-         << endl; 
+// Reads a grid size given on the command line as WxH
+// Returns false if str is not of that form.
+bool ParseBoard(const string &str, int &width, int &height){
+  size_t x = str.find_first_of("xX");   // position of the separator
+  if(x == string::npos || x == 0 || x + 1 == str.length() 
+     || str.find_first_not_of("0123456789", x + 1) != string::npos 
+     || str.find_first_not_of("0123456789") != x){
+    return false;
   }
+  width = stoi(str.substr(0, x));
+  height = stoi(str.substr(x + 1));
+  return true;
 }
 
-// Writes to log.txt whenever the player or computer fires. 
-// Also writes the point(x,y) fired upon
-void Game::LogFire(int tarCol, int tarRow, Player p){
-  file << "\n" << GetTime(); 
-  if(p == USER){
-    file << " Player";
-  }
-  else{
-    file << " Computer";
+
+// Reads a fleet given on the command line as comma separated ship sizes
+// Returns false if str is not of that form.
+bool ParseFleet(const string &str, vector<int> &fleet){
+  fleet.clear();
+  size_t start = 0;   // start of the next ship size
+  while(start <= str.length()){
+    size_t end = min(str.find(',', start), str.length());   // end of the ship size
+    string size = str.substr(start, end - start);
+    if(size.empty() || size.length() > 2 || size.find_first_not_of("0123456789") != string::npos){
+      return false;
+    }
+    fleet.push_back(stoi(size));
+    start = end + 1;
   }
-  file << " fired at (" 
-       << char(tarRow + 65) << ", " 
-       << tarCol + 1 << ").";
+  return true;
 }
 
-//Writes to log.txt when a shot is determined to be a hit
-void Game::LogHit(){
-  file << " It was a HIT." << endl;
-}
 
-//Writes to log.txt when a shot is determined to be a miss
-void Game::LogMiss(){
-  file << " It was a MISS." << endl;
+// Returns a random seed for a new game drawn from the system's entropy source
+// mixed with the current time.
+uint64_t NewSeed(){
+  random_device device;
+  return (uint64_t(device()) << 32 | device()) ^ uint64_t(time(nullptr));
 }
 
-void Game::LogShotDown(){
-  file << " The missile was SHOT DOWN." << endl;
-}
 
-//Writes to log.txt when a ship is damaged
-void Game::LogDamage(int shipLoc, Player p){
-  if(p == USER){
-    file << "The computer's " << compFleet[shipLoc].getName()       << " was damaged." 
-         << " Health reduced to " 
-         << compFleet[shipLoc].getHealth() 
-         << "/" 
-         << compFleet[shipLoc].getSize() 
-         << "." 
-         << endl;
-  }
-  else{
-    file << "The player's " << userFleet[shipLoc].getName() << " was damaged." 
-    << " Health reduced to " 
-    << userFleet[shipLoc].getHealth() 
-    << "/" 
-    << userFleet[shipLoc].getSize() 
-    << "." 
-    << endl;
+// Measures the average cost of one bounded random draw in nanoseconds.
+// Used by the simulation report to show what random numbers cost per game.
+double RandomCost(){
+  const int numDraws = 10000000;    // draws to time
+  RandomGenerator generator(NewSeed());
+  int sum = 0;                      // total of the draws
+  volatile int sink;                // keeps the draws inside the timed region
+  auto start = chrono::steady_clock::now();
+  for(int i = 0; i < numDraws; i++){
+    sum += generator.Below(10);
   }
+  sink = sum;
+  double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  return sink < 0 ? 0 : ns / numDraws;
 }
 
-//Writes to log.txt when a ship is sunk
-void Game::LogSink(int shipLoc, Player p){
-  if(p == USER){
-    file << "The computer's " << compFleet[shipLoc].getName() << " was sunk." 
-         << endl;
+
+/*
+  Below exists all functions of the C interface declared in battleship.h.
+  Built with -DBATTLESHIP_LIBRARY, the program leaves out main() and these
+  are what a program linking the library calls.
+*/
+
+
+// Calls f with a null pointer to the variant a game with config is played 
+// with. A grid and fleet that no FixedVariant covers configures the 
+// RuntimeVariant the first time it is asked for; it can not be configured
+// for anything else afterwards, since games may already be using it.
+// Returns false if config is invalid.
+template<class F>
+bool WithEngineVariant(const bs_config &config, F f){
+  static mutex lock;                          // guards configuring the RuntimeVariant
+  static bool runtimeConfigured = false;      // true once the RuntimeVariant was configured
+  int width = config.width > 0 ? config.width : 10,       // columns of the grid
+      height = config.height > 0 ? config.height : 10;    // rows of the grid
+  vector<int> fleet(ClassicFleet::sizes, ClassicFleet::sizes + ClassicFleet::numShips);
+  if(config.gametype < CLASSIC || config.gametype > HARDCORE || config.num_ships < 0
+     || (config.num_ships > 0 && config.ship_sizes == nullptr)){
+    return false;
+  }
+  if(config.num_ships > 0){
+    fleet.assign(config.ship_sizes, config.ship_sizes + config.num_ships);
+  }
+  bool classicFleet = fleet == vector<int>(ClassicFleet::sizes, ClassicFleet::sizes + ClassicFleet::numShips);
+  if(classicFleet && width == 10 && height == 10){
+    f((Classic *)nullptr);
+    return true;
+  }
+  if(classicFleet && width == 15 && height == 15){
+    f((Classic15 *)nullptr);
+    return true;
+  }
+  if(classicFleet && width == 20 && height == 20){
+    f((Classic20 *)nullptr);
+    return true;
+  }
+  lock_guard<mutex> hold(lock);
+  if(!runtimeConfigured){
+    runtimeConfigured = RuntimeVariant::Configure(width, height, fleet);
+    if(!runtimeConfigured){
+      return false;
+    }
   }
   else{
-    file << "The player's " << userFleet[shipLoc].getName() << " was sunk." 
-         << endl;
+    bool same = width == RuntimeVariant::Width() && height == RuntimeVariant::Height() 
+                && (int)fleet.size() == RuntimeVariant::NumShips();   // true if config matches
+    for(int i = 0; same && i < (int)fleet.size(); i++){
+      same = fleet[i] == RuntimeVariant::ShipSize(i);
+    }
+    if(!same){
+      return false;
+    }
   }
+  f((RuntimeVariant *)nullptr);
+  return true;
 }
 
-//Writes to log.txt whenever the user or computer wins.
-void Game::LogWin(Player p){
-  if(p == USER){
-    file << "\n" << GetTime() << " The Player WON!" << endl;
+
+// Copies a shot resolved by the game to the results of the turn being 
+// played and reports it to the callback
+void EngineGame::ShotFired(Player p, int tarCol, int tarRow, SquareState result, int shipLoc){
+  bs_shot shot = {uint8_t(p), uint8_t(tarRow), uint8_t(tarCol), uint8_t(result), int8_t(shipLoc)};
+  if(results != nullptr){
+    results[numResults] = shot;
   }
-  else{
-    file << "\n" << GetTime() << " The Computer WON!" << endl;
+  numResults++;
+  if(callback != nullptr){
+    callback(context, &shot);
   }
 }
 
 
-// Gets the current date.
-string Game::GetDate(){
-  string timeStr;   //string to store the date
-  time_t currentTime = time(nullptr);
-  tm* timePtr = localtime(&currentTime);
-  timeStr = 
-         to_string(timePtr->tm_mday) + "/"
-       + to_string((timePtr->tm_mon) + 1) + "/"
-       + to_string((timePtr->tm_year)+1900);
-  return timeStr;
+// Starts over with empty fleets
+template<class V>
+void BasicEngineGame<V>::Reset(Gametype gt, uint64_t seed){
+  game.Reset(gt, seed);
+  game.ConstructFleets();
+  toMove = USER;
 }
 
 
-// Gets the current time.
-string Game::GetTime(){
-  string timeStr;   //string to store the time
-  time_t currentTime = time(nullptr);
-  tm* timePtr = localtime(&currentTime);
-  timeStr =
-         to_string(timePtr->tm_hour) + ":"
-       + to_string(timePtr->tm_min) +":"
-       + to_string(timePtr->tm_sec);
-  return timeStr;
+// Places ship shipLoc of Player p's fleet with its first square at (row,
+// column), if it is not placed yet and fits there
+template<class V>
+bool BasicEngineGame<V>::Place(Player p, int shipLoc, int row, int column, bool vertical){
+  if(game.getGamestate() != WAITING || shipLoc < 0 || shipLoc >= V::NumShips() || row < 0
+     || row >= V::Height() || column < 0 || column >= V::Width() || game.getFleet(p)[shipLoc].getMask().Any()){
+    return false;
+  }
+  return game.PlaceRecordedShip(shipLoc, p, BasicBitboard<V>::Index(column, row), vertical);
 }
 
 
-/*
-  Below exists all functions used for the AIOpponent class
-*/
+// Places Player p's whole fleet at random
+template<class V>
+bool BasicEngineGame<V>::PlaceRandom(Player p){
+  if(game.getGamestate() != WAITING){
+    return false;
+  }
+  game.RandomPlacement(p);
+  return true;
+}
 
-// Main AI function: creates a 2D array filled with integers representing the 
-// probability that a ship is contained at its location.
-// Assumes standard distribution of ships, with each coordinate as likely to 
-// contain a ship as the next when looking at an empty board.
-// TODO: Optimize algorithm
-pair<int, int> AIOpponent::EvaluateGrid(const Game &game, int s ){
-  SquareState tmpSS;        // temporary SquareState variable to be used for comparison
-  int high = 0;             // value used for comparison to find the most weighted gridpoint
-  int highX, highY;         // variables used to store location of the most weighted gridpoint
-  int tmp[10][10] = {0};    // temporary grid of integers to represent how much weight  
-                            // each square has
-  // Loops through all of the spaces on the grid, incrementing values in grid tmp based on the
-  // probability that a part of a ship is contained at those coordinates;
-  for(int x = 0; x < 10; x++){
-    for(int y = 0; y < 10; y++){
-      tmpSS = game.compTargeting[x][y].getSquareState();    
-      if(tmpSS == EMPTY){
-        // Iterates from the argument s (representing the size of the smallest player ship AFLOAT)
-        // to 5, the largest possible ship size. At each iteration, the AI checks if a ship of size i
-        // can fit vertically or horizontally in the four possible directions from the current point. 
-        // Weight values are then incremented by 1 for each time a ship is able to fit in the spots of
-        // the given directions.
-        // ex: Assuming an empty board - at x = 0, y = 0, only CheckRight and CheckDown will return true.
-        //     From this, only the squares to the right and squares down will be incremented by 1 for up 
-        //     to i spaces away. 
-        for(int i = s; i <= 5; i++){
-          if(EvalUp(game, x, y, i)){
-            for(int n = 0; n < i - 1; n++){
-              tmp[x][y-n] += 1;
-            }
-          }
-          if(EvalDown(game, x, y, i)){
-            for(int n = 0; n < i - 1; n++){
-              tmp[x][y+n] += 1;
-            }
-          }
-          if(EvalLeft(game, x, y, i)){
-            for(int n = 0; n < i - 1; n++){
-              tmp[x - n][y] += 1;
-            }
-          }
-          if(EvalRight(game, x, y, i)){
-            for(int n = 0; n < i - 1; n++){
-              tmp[x + n][y] += 1;
-            }
-          }
-        }
-      } 
-      // If a square is a HIT, special weighting is applied to the immediate surrounding coordinates.
-      // This will check if the additional wighting can be applied UP TO 2 spaces away, but may not attempt
-      // to apply weighting at all if a ship cannot fit in that direction.
-      else if(tmpSS == HIT){
-        if(EvalUp(game, x, y, 3)){
-          tmp[x][y-1] += 100;
-          tmp[x][y-2] += 50;
-        }
-        else if(EvalUp(game, x, y, 2)){
-          tmp[x][y-1] += 100;
-        }
-        if(EvalDown(game, x, y, 3)){
-          tmp[x][y+1] += 100;
-          tmp[x][y+2] += 50;
-        }
-        else if(EvalDown(game, x, y, 2)){
-          tmp[x][y+1] += 100;
-        }
-        if(EvalLeft(game, x, y, 3)){
-          tmp[x-1][y] += 100;
-          tmp[x-2][y] += 50;
-        }
-        else if(EvalLeft(game, x, y, 2)){
-          tmp[x-1][y] += 100;
-        }
-        if(EvalRight(game, x, y, 3)){
-          tmp[x+1][y] += 100;
-          tmp[x+2][y] += 50;
-        }
-        else if(EvalRight(game, x, y, 2)){
-          tmp[x+1][y] += 100;
-        }
-      }  
-      // A square with a state of SHOT_DOWN is given immense weight to ensure that the square is retargeted.
-      else if(tmpSS == SHOT_DOWN){
-        tmp[x][y] += 1000;
-      }
-    }
+
+// Starts play if every ship of both fleets is placed
+template<class V>
+bool BasicEngineGame<V>::Start(){
+  if(game.getGamestate() != WAITING){
+    return false;
   }
-  // Loops through the grid again to ensure no shots are performed on squares of HIT, MISS, or SINK,
-  // as these squares may have recieved weight in the previous loops.
-  for(int x = 0; x < 10; x++){
-    for(int y = 0; y < 10; y++){
-      tmpSS = game.compTargeting[x][y].getSquareState();
-      // Specification C2 - Prohibit AI wasted shots
-      if(tmpSS == HIT || tmpSS == MISS || tmpSS == SINK){
-        tmp[x][y] = 0;
-      }
-      if(tmp[x][y] > high){
-        high = tmp[x][y];
-        highX = x;
-        highY = y;
+  for(Player p : {USER, COMP}){
+    for(int i = 0; i < V::NumShips(); i++){
+      if(!game.getFleet(p)[i].getMask().Any()){
+        return false;
       }
     }
   }
-  //DisplayProbabilityGrid(tmp);  //uncomment for debugging
-  return make_pair(highY, highX);
+  game.Start();
+  toMove = USER;
+  return true;
 }
 
 
-// Used solely in debugging
-// Displays the weight each square is given by the AI
-// Would have used DisplayGrid, but requirements are different
-// i.e. DisplayProbabilityGrid prints numbers not symbols
-// and takes in a 2D array of ints, not squares.
-// Thought about implementing a conversion constructor, but decided
-// that solution was less efficient than constructing a new function
-/* EX:
-    COMP PROBABILITY GRID
-        1   2   3   4   5   6   7   8   9  10
-      -----------------------------------------
-    A | 8 | 15| 20| 23| 24| 24| 23| 20| 15| 8 |
-      -----------------------------------------
-    B | 15| 22| 27| 30| 31| 31| 30| 27| 22| 15|
-      -----------------------------------------
-    C | 20| 27| 32| 35| 36| 36| 35| 32| 27| 20|
-      -----------------------------------------
-    D | 23| 30| 35| 38| 39| 39| 38| 35| 30| 23|
-      -----------------------------------------
-    E | 24| 31| 36| 39| 40| 40| 39| 36| 31| 24|
-      -----------------------------------------
-    F | 24| 31| 36| 39| 40| 40| 39| 36| 31| 24|
-      -----------------------------------------
-    G | 23| 30| 35| 38| 39| 39| 38| 35| 30| 23|
-      -----------------------------------------
-    H | 20| 27| 32| 35| 36| 36| 35| 32| 27| 20|
-      -----------------------------------------
-    I | 15| 22| 27| 30| 31| 31| 30| 27| 22| 15|
-      -----------------------------------------
-    J | 8 | 15| 20| 23| 24| 24| 23| 20| 15| 8 |
-      -----------------------------------------
-*/
-void AIOpponent::DisplayProbabilityGrid(int grid [10][10]){
-  cout << "\nCOMP PROBABILITY GRID";
-  cout << "\n    1   2   3   4   5   6   7   8   9  10" << endl;
-  cout << "  -----------------------------------------" << endl;
-  for (int row = 0; row < 10; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (col == 0){
-        switch(row){
-        case 0: cout<< "A ";
-          break;
-        case 1: cout<< "B ";
-          break;
-        case 2: cout<< "C ";
-          break;
-        case 3: cout<< "D ";
-          break;
-        case 4: cout<< "E ";
-          break;
-        case 5: cout<< "F ";
-          break;
-        case 6: cout<< "G ";
-          break;
-        case 7: cout<< "H ";
-          break;
-        case 8: cout<< "I ";
-          break;
-        case 9: cout<< "J ";
-          break;
-        }
-        cout << "|";
-      }
-      if(grid[col][row] < 100){
-        cout << " ";
-      }
-      cout  << grid[col][row];
-      if(grid[col][row] < 10){
-        cout << " ";
-      }
-      if (col < 10) {
-        cout << "|";
-      }
+// Plays the user's turn, as Game::PlayerTurn does once the targets are in.
+// Every target is checked before any is fired at, so a rejected turn leaves
+// the game as it was.
+template<class V>
+int BasicEngineGame<V>::Fire(const bs_target targets[], int count, bs_shot out[]){
+  const BasicBoard<V> &targeting = game.getTargeting(USER);   // grid the user fires upon
+  BasicBitboard<V> chosen;                                    // squares targeted so far
+  if(game.getGamestate() != PLAYING || toMove != USER || count < 1 || count > game.ShotsPerTurn(USER)){
+    return BS_ERROR;
+  }
+  for(int i = 0; i < count; i++){
+    int row = targets[i].row, 
+        column = targets[i].column;
+    if(row >= V::Height() || column >= V::Width() || chosen.Test(BasicBitboard<V>::Index(column, row))){
+      return BS_ERROR;
     }
-    cout << "\n";
-    if (row < 9) {
-      cout << "  -----------------------------------------" << endl;
+    SquareState state = targeting.getSquareState(column, row);   // what was found there so far
+    if(state != EMPTY && state != SHOT_DOWN){
+      return BS_ERROR;
     }
+    chosen |= BasicBitboard<V>::At(column, row);
+  }
+  results = out;
+  numResults = 0;
+  for(int i = 0; i < count; i++){
+    game.CheckHit(make_pair(int(targets[i].row), int(targets[i].column)), USER);
+  }
+  results = nullptr;
+  if(!game.CheckWin(USER)){
+    toMove = COMP;
   }
-    cout << "  -----------------------------------------\n" << endl;
+  return count;
 }
 
 
-//Checks to see if a ship of size 's' can fit vertically above point (x,y)
-bool AIOpponent::EvalUp(const Game &game, int x, int y, int s){
-  bool isEmpty = true;
-  if(y - (s - 1) < 0){
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(game.compTargeting[x][y-n].getSquareState() == MISS 
-      || game.compTargeting[x][y-n].getSquareState() == SINK){
-        isEmpty = false;
-        break;
-      }
-    }
+// Plays the computer's turn
+template<class V>
+int BasicEngineGame<V>::CompTurn(bs_shot out[]){
+  if(game.getGamestate() != PLAYING || toMove != COMP){
+    return BS_ERROR;
   }
-  return isEmpty;
+  results = out;
+  numResults = 0;
+  game.CompTurn();
+  results = nullptr;
+  if(!game.CheckWin(COMP)){
+    toMove = USER;
+  }
+  return numResults;
 }
 
 
-//Checks to see if a ship of size 's' can fit vertically below point (x,y)
-bool AIOpponent::EvalDown(const Game &game, int x, int y, int s){
-  bool isEmpty = true;
-  if(y + (s - 1) > 9){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(game.compTargeting[x][y+n].getSquareState() == MISS 
-      || game.compTargeting[x][y+n].getSquareState() == SINK){
-        isEmpty = false;
-        break;
-      }
-    }
+// Sinks Player p's fleet, so the other side wins
+template<class V>
+bool BasicEngineGame<V>::Forfeit(Player p){
+  if(game.getGamestate() != PLAYING){
+    return false;
   }
-  return isEmpty;
+  game.Forfeit(p);
+  game.CheckWin(p == USER ? COMP : USER);
+  return true;
 }
 
 
-//Checks to see if a ship of size 's' can fit horizontally to the right of point (x,y)
-bool AIOpponent::EvalRight(const Game &game, int x, int y, int s){
-  bool isEmpty = true;
-  if(x + (s - 1) > 9){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(game.compTargeting[x + n][y].getSquareState() == MISS 
-      || game.compTargeting[x + n][y].getSquareState() == SINK){
-        isEmpty = false;
-        break;
+template<class V>
+void BasicEngineGame<V>::Status(bs_status &status) const{
+  status.state = game.getGamestate();
+  status.gametype = game.getGametype();
+  status.to_move = toMove;
+  status.width = V::Width();
+  status.height = V::Height();
+  status.num_ships = V::NumShips();
+  bool multifire = game.getGametype() == MULTIFIRE || game.getGametype() == HARDCORE;
+  for(Player p : {USER, COMP}){
+    status.afloat[p] = 0;
+    for(int i = 0; i < V::NumShips(); i++){
+      if(game.getFleet(p)[i].getShipState() == AFLOAT){
+        status.afloat[p] |= 1 << i;
       }
     }
+    status.shots_per_turn[p] = multifire ? __builtin_popcount(status.afloat[p]) : 1;
   }
-  return isEmpty;
 }
 
 
-//Checks to see if a ship of size 's' can fit horizontally to the left of point (x,y)
-bool AIOpponent::EvalLeft(const Game &game, int x, int y, int s){
-  bool isEmpty = true;
-  if(x - (s - 1) < 0){ 
-    isEmpty = false;
-  } else{
-    for(int n = 1; n < s - 1; n++){
-      if(game.compTargeting[x - n][y].getSquareState() == MISS 
-      || game.compTargeting[x - n][y].getSquareState() == SINK){
-        isEmpty = false;
-        break;
-      }
+// Copies one of the game's grids to cells, row by row
+template<class V>
+int BasicEngineGame<V>::Grid(int grid, uint8_t cells[]) const{
+  if(grid < BS_USER_SHIPS || grid > BS_COMP_TARGETING){
+    return BS_ERROR;
+  }
+  Player p = grid == BS_USER_SHIPS || grid == BS_USER_TARGETING ? USER : COMP;   // owner of the grid
+  const BasicBoard<V> &board = grid == BS_USER_SHIPS || grid == BS_COMP_SHIPS ? game.getShips(p) 
+                                                                              : game.getTargeting(p);
+  for(int row = 0; row < V::Height(); row++){
+    for(int column = 0; column < V::Width(); column++){
+      cells[row * V::Width() + column] = board.getSquareState(column, row);
     }
   }
-  return isEmpty;
+  return V::Squares();
 }
 
 
-//Used by AI to determine the size of the smallest ship afloat in the player's fleet
-int AIOpponent::SmallestShipAlive(const Game &game){
-  int small = 5;    // variable to hold the size of the smallest ship
-  int tmpInt;       // temporary int used to make comparisons to small
-  for(int i = 0; i < 5; i++){
-    if(game.userFleet[i].getShipState() == AFLOAT){
-      tmpInt = game.userFleet[i].getSize();
-      if(tmpInt < small){
-        small = tmpInt;
-      }
+extern "C" {
+
+size_t bs_game_size(const bs_config *config){
+  size_t size = 0;    // bytes taken by a game of the config's variant
+  WithEngineVariant(*config, [&](auto *variant){
+    size = sizeof(BasicEngineGame<remove_pointer_t<decltype(variant)> >);
+  });
+  return size;
+}
+
+
+bs_game *bs_game_init(void *memory, size_t size, const bs_config *config){
+  EngineGame *game = nullptr;   // game constructed in memory
+  if(memory == nullptr || uintptr_t(memory) % BS_GAME_ALIGN != 0){
+    return nullptr;
+  }
+  WithEngineVariant(*config, [&](auto *variant){
+    using Engine = BasicEngineGame<remove_pointer_t<decltype(variant)> >;
+    static_assert(alignof(Engine) <= BS_GAME_ALIGN, "games must fit the alignment promised in battleship.h");
+    if(size >= sizeof(Engine)){
+      game = new(memory) Engine(Gametype(config->gametype), config->seed);
     }
+  });
+  return reinterpret_cast<bs_game *>(game);
+}
+
+
+void bs_game_destroy(bs_game *game){
+  reinterpret_cast<EngineGame *>(game)->~EngineGame();
+}
+
+
+int bs_game_reset(bs_game *game, int gametype, uint64_t seed){
+  if(gametype < CLASSIC || gametype > HARDCORE){
+    return BS_ERROR;
   }
-  return small;
-}
\ No newline at end of file
+  reinterpret_cast<EngineGame *>(game)->Reset(Gametype(gametype), seed);
+  return 0;
+}
+
+
+void bs_game_set_callback(bs_game *game, bs_shot_callback callback, void *context){
+  reinterpret_cast<EngineGame *>(game)->setCallback(callback, context);
+}
+
+
+int bs_game_place(bs_game *game, int player, int ship, int row, int column, int vertical){
+  if(player != USER && player != COMP){
+    return BS_ERROR;
+  }
+  return reinterpret_cast<EngineGame *>(game)->Place(Player(player), ship, row, column, vertical) ? 0 : BS_ERROR;
+}
+
+
+int bs_game_place_random(bs_game *game, int player){
+  if(player != USER && player != COMP){
+    return BS_ERROR;
+  }
+  return reinterpret_cast<EngineGame *>(game)->PlaceRandom(Player(player)) ? 0 : BS_ERROR;
+}
+
+
+int bs_game_start(bs_game *game){
+  return reinterpret_cast<EngineGame *>(game)->Start() ? 0 : BS_ERROR;
+}
+
+
+int bs_game_fire(bs_game *game, const bs_target *targets, int count, bs_shot *results){
+  return reinterpret_cast<EngineGame *>(game)->Fire(targets, count, results);
+}
+
+
+int bs_game_computer_turn(bs_game *game, bs_shot *results){
+  return reinterpret_cast<EngineGame *>(game)->CompTurn(results);
+}
+
+
+int bs_game_forfeit(bs_game *game, int player){
+  if(player != USER && player != COMP){
+    return BS_ERROR;
+  }
+  return reinterpret_cast<EngineGame *>(game)->Forfeit(Player(player)) ? 0 : BS_ERROR;
+}
+
+
+void bs_game_status(const bs_game *game, bs_status *status){
+  reinterpret_cast<const EngineGame *>(game)->Status(*status);
+}
+
+
+int bs_game_grid(const bs_game *game, int grid, uint8_t *cells){
+  return reinterpret_cast<const EngineGame *>(game)->Grid(grid, cells);
+}
+
+}
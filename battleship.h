@@ -0,0 +1,150 @@
+/**
+battleship.h
+
+C interface to the battleship engine, for programs that link the game in
+rather than running it at a terminal. Build the library with
+-DBATTLESHIP_LIBRARY, which leaves out main():
+
+    g++ -std=c++20 -O2 -pthread -fPIC -shared -fvisibility=hidden
+        -DBATTLESHIP_LIBRARY battleship.cpp -o libbattleship.so
+
+A game is played between the user (the caller's player) and the computer,
+with the same rules as the interactive game. The game lives in memory owned
+by the caller, and every call works on caller-owned memory: nothing is
+printed or logged, and once a game is initialized no call allocates.
+Each shot is returned as a bs_shot and reported to the callback, if one is
+set. Calls on different games may be made from different threads.
+
+Rows are numbered from 0 (row A) and columns from 0 (column 1).
+
+@version 1.0
+*/
+#ifndef BATTLESHIP_H
+#define BATTLESHIP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BS_API __attribute__((visibility("default")))
+
+// Returned by any call given arguments that are invalid at that point of the game
+#define BS_ERROR (-1)
+
+// Memory given to bs_game_init must be aligned to this many bytes
+#define BS_GAME_ALIGN 64
+
+typedef struct bs_game bs_game;
+
+typedef enum bs_gametype{BS_CLASSIC, BS_MULTIFIRE, BS_CRUISE_MISSILES, BS_HARDCORE} bs_gametype;
+typedef enum bs_player{BS_USER, BS_COMP} bs_player;
+typedef enum bs_state{BS_WAITING, BS_PLAYING, BS_USER_WON, BS_COMP_WON} bs_state;
+typedef enum bs_square{BS_MISS, BS_HIT, BS_EMPTY, BS_SHIP, BS_SINK, BS_SHOT_DOWN} bs_square;
+typedef enum bs_grid{BS_USER_SHIPS, BS_USER_TARGETING, BS_COMP_SHIPS, BS_COMP_TARGETING} bs_grid;
+
+// Grid size, fleet and rules of a game
+// The standard fleet on a 10x10, 15x15 or 20x20 grid is always available.
+// Any other grid from 5x5 to 26x26 with 1 to 10 ships of size 2 to 8 is
+// available as well, but only one such grid and fleet per process.
+typedef struct bs_config{
+  int width;                  // columns of the grid, 0 for 10
+  int height;                 // rows of the grid, 0 for 10
+  int num_ships;              // ships in each fleet, 0 for the standard 5,4,3,3,2
+  const int *ship_sizes;      // size of each ship
+  int gametype;               // bs_gametype
+  uint64_t seed;              // seed of the game's random number generator
+} bs_config;
+
+// Square to fire at
+typedef struct bs_target{
+  uint8_t row;
+  uint8_t column;
+} bs_target;
+
+// One shot and its result
+typedef struct bs_shot{
+  uint8_t player;             // bs_player who fired
+  uint8_t row;
+  uint8_t column;
+  uint8_t result;             // BS_MISS, BS_HIT, BS_SINK or BS_SHOT_DOWN
+  int8_t ship;                // ship on the square in the fleet fired at, -1 if none
+} bs_shot;
+
+// Where a game stands
+typedef struct bs_status{
+  uint8_t state;              // bs_state
+  uint8_t gametype;           // bs_gametype
+  uint8_t to_move;            // bs_player whose turn it is while BS_PLAYING
+  uint8_t width;
+  uint8_t height;
+  uint8_t num_ships;          // ships in each fleet
+  uint8_t shots_per_turn[2];  // shots each bs_player fires on its next turn
+  uint16_t afloat[2];         // bit i is set while ship i of each bs_player's fleet is afloat
+} bs_status;
+
+// Called with every shot as soon as it is resolved
+typedef void (*bs_shot_callback)(void *context, const bs_shot *shot);
+
+// Bytes of memory a game with the given config takes, 0 if the config is invalid
+BS_API size_t bs_game_size(const bs_config *config);
+
+// Starts a game in memory, which must hold bs_game_size bytes aligned to
+// BS_GAME_ALIGN. Both fleets are empty and the game is BS_WAITING.
+// Returns the game, or NULL if the config is invalid or memory too small.
+BS_API bs_game *bs_game_init(void *memory, size_t size, const bs_config *config);
+
+// Ends the game; its memory may be freed afterwards
+BS_API void bs_game_destroy(bs_game *game);
+
+// Starts over with empty fleets, keeping the grid, fleet and callback.
+// Returns 0, or BS_ERROR if gametype is not a bs_gametype.
+BS_API int bs_game_reset(bs_game *game, int gametype, uint64_t seed);
+
+// Reports every shot to callback, or stops reporting if callback is NULL
+BS_API void bs_game_set_callback(bs_game *game, bs_shot_callback callback, void *context);
+
+// Places ship number ship of player's fleet with its first square at (row,
+// column), running along the row or down the column if vertical is set.
+// Returns 0, or BS_ERROR if the ship was already placed, does not fit or the
+// game has started.
+BS_API int bs_game_place(bs_game *game, int player, int ship, int row, int column, int vertical);
+
+// Places player's whole fleet at random, replacing any ship already placed.
+// Returns 0, or BS_ERROR if the game has started.
+BS_API int bs_game_place_random(bs_game *game, int player);
+
+// Starts play once both fleets are placed; the user fires first.
+// Returns 0, or BS_ERROR if a ship is not placed or the game has started.
+BS_API int bs_game_start(bs_game *game);
+
+// Plays the user's turn, firing at count targets. count may be anything from
+// 1 to the user's shots_per_turn, and no square may be fired at twice (a 
+// missile that was shot down may be fired again, once per turn). results,
+// unless NULL, receives the shots.
+// Returns the number of shots fired, or BS_ERROR.
+BS_API int bs_game_fire(bs_game *game, const bs_target *targets, int count, bs_shot *results);
+
+// Plays the computer's turn, which follows each of the user's. results,
+// unless NULL, receives the shots and needs room for the computer's
+// shots_per_turn. Returns the number of shots fired, or BS_ERROR.
+BS_API int bs_game_computer_turn(bs_game *game, bs_shot *results);
+
+// Gives up the game on behalf of player. Returns 0, or BS_ERROR if the game
+// is not being played.
+BS_API int bs_game_forfeit(bs_game *game, int player);
+
+// Fills status with where the game stands
+BS_API void bs_game_status(const bs_game *game, bs_status *status);
+
+// Copies a grid to cells as width * height bs_square values, row by row.
+// Returns the number of cells copied, or BS_ERROR if grid is invalid.
+BS_API int bs_game_grid(const bs_game *game, int grid, uint8_t *cells);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif